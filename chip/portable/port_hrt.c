@@ -0,0 +1,307 @@
+/*****************************************************************************
+ *
+ * MODULE:             port_hrt
+ *
+ * COMPONENT:          port_hrt.c
+ *
+ * DESCRIPTION:        High resolution one-shot timers
+ *
+ * Any number of microsecond deadlines share the TIM2 compare channel. Armed
+ * timers are kept in a list sorted on deadline and only the head is ever
+ * programmed; the 16 bit counter is extended to 32 bits by counting its
+ * overflows, so a deadline can be up to 35 minutes ahead. A deadline further
+ * than one counter period is looked at again on each overflow. Callbacks run
+ * in the TIM2 interrupt and may arm timers again.
+ *
+ ****************************************************************************
+ *
+ * This software is owned by NXP B.V. and/or its supplier and is protected
+ * under applicable copyright laws. All rights are reserved. We grant You,
+ * and any third parties, a license to use this software solely and
+ * exclusively on NXP products [NXP Microcontrollers such as JN5168, JN5179].
+ * You, and any third parties must reproduce the copyright and warranty notice
+ * and any other legend of ownership on each copy or partial copy of the
+ * software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Copyright NXP B.V. 2016. All rights reserved
+ *
+ ***************************************************************************/
+
+/****************************************************************************/
+/***        Include files                                                 ***/
+/****************************************************************************/
+
+#include <stddef.h>
+#include "port_mcu.h"
+#include "port_hrt.h"
+
+#ifdef PORTABLE_SUPPORT_HRT
+
+/****************************************************************************/
+/***        Macro Definitions                                             ***/
+/****************************************************************************/
+
+/* Deadlines compare as signed differences, so they must stay within this of now */
+#define HRT_MAX_DELAY_US          (0x7FFFFFFFUL)
+
+/****************************************************************************/
+/***        Type Definitions                                              ***/
+/****************************************************************************/
+
+/****************************************************************************/
+/***        Local Function Prototypes                                     ***/
+/****************************************************************************/
+static void HRT_vInsert(HRT_tsTimer *psTimer);
+static void HRT_vRemove(HRT_tsTimer *psTimer);
+static void HRT_vProgram(void);
+static void HRT_vService(void);
+
+/****************************************************************************/
+/***        Exported Variables                                            ***/
+/****************************************************************************/
+
+/****************************************************************************/
+/***        Local Variables                                               ***/
+/****************************************************************************/
+
+static HRT_tsTimer *psHrtHead;          /* Armed timer with the earliest deadline */
+static volatile uint16 u16HrtOverflows; /* High half of HRT_u32Now */
+
+/****************************************************************************/
+/***        Exported Functions                                            ***/
+/****************************************************************************/
+
+void HRT_vInit(void)
+{
+    psHrtHead = NULL;
+    u16HrtOverflows = 0;
+
+    PORTABLE_vHrtInit();
+}
+
+uint32 HRT_u32Now(void)
+{
+    uint16 u16High;
+    uint16 u16Low;
+    bool_t bPending;
+
+    /* Read again if the overflow interrupt ran in between */
+    do
+    {
+        u16High = u16HrtOverflows;
+        u16Low = PORTABLE_u16HrtCounter();
+        bPending = PORTABLE_bHrtOverflowPending();
+
+        /* The counter wrapped but the interrupt has not run yet (masked, or
+           the caller is a higher priority ISR): take a value past the wrap */
+        if (bPending)
+        {
+            u16Low = PORTABLE_u16HrtCounter();
+        }
+    } while (u16High != u16HrtOverflows);
+
+    if (bPending)
+    {
+        u16High++;
+    }
+
+    return ((uint32)u16High << 16) | u16Low;
+}
+
+bool_t HRT_bStart(HRT_tsTimer *psTimer, uint32 u32Micros, HRT_tpfCallback pfCallback, void *pvParam)
+{
+    if (u32Micros > HRT_MAX_DELAY_US)
+    {
+        return FALSE;
+    }
+
+    return HRT_bStartAt(psTimer, HRT_u32Now() + u32Micros, pfCallback, pvParam);
+}
+
+bool_t HRT_bStartAt(HRT_tsTimer *psTimer, uint32 u32Deadline, HRT_tpfCallback pfCallback, void *pvParam)
+{
+    uint8 u8State;
+
+    if (pfCallback == NULL)
+    {
+        return FALSE;
+    }
+
+    u8State = PORTABLE_u8EnterCritical();
+
+    /* Arming an armed timer moves it to the new deadline */
+    if (psTimer->bArmed)
+    {
+        HRT_vRemove(psTimer);
+    }
+
+    psTimer->u32Deadline = u32Deadline;
+    psTimer->pfCallback = pfCallback;
+    psTimer->pvParam = pvParam;
+    psTimer->bArmed = TRUE;
+    HRT_vInsert(psTimer);
+
+    /* Only a new head moves the compare channel */
+    if (psHrtHead == psTimer)
+    {
+        HRT_vProgram();
+    }
+
+    PORTABLE_vExitCritical(u8State);
+
+    return TRUE;
+}
+
+bool_t HRT_bCancel(HRT_tsTimer *psTimer)
+{
+    uint8 u8State = PORTABLE_u8EnterCritical();
+    bool_t bArmed = psTimer->bArmed;
+
+    if (bArmed)
+    {
+        bool_t bHead = (bool_t)(psHrtHead == psTimer);
+
+        HRT_vRemove(psTimer);
+        psTimer->bArmed = FALSE;
+
+        if (bHead)
+        {
+            HRT_vProgram();
+        }
+    }
+
+    PORTABLE_vExitCritical(u8State);
+
+    /* FALSE: the callback already ran or is running */
+    return bArmed;
+}
+
+bool_t HRT_bIsArmed(HRT_tsTimer *psTimer)
+{
+    return psTimer->bArmed;
+}
+
+void HRT_vIsrOverflow(void)
+{
+    u16HrtOverflows++;
+
+    /* A far deadline may have come within one counter period */
+    HRT_vService();
+}
+
+void HRT_vIsrCompare(void)
+{
+    HRT_vService();
+}
+
+/****************************************************************************/
+/***        Local Functions                                               ***/
+/****************************************************************************/
+
+/* Links the timer after the armed timers with the same or an earlier deadline */
+static void HRT_vInsert(HRT_tsTimer *psTimer)
+{
+    HRT_tsTimer **ppsLink = &psHrtHead;
+
+    while ((*ppsLink != NULL) &&
+           ((int32)((*ppsLink)->u32Deadline - psTimer->u32Deadline) <= 0))
+    {
+        ppsLink = &(*ppsLink)->psNext;
+    }
+
+    psTimer->psNext = *ppsLink;
+    *ppsLink = psTimer;
+}
+
+static void HRT_vRemove(HRT_tsTimer *psTimer)
+{
+    HRT_tsTimer **ppsLink = &psHrtHead;
+
+    while (*ppsLink != NULL)
+    {
+        if (*ppsLink == psTimer)
+        {
+            *ppsLink = psTimer->psNext;
+            break;
+        }
+        ppsLink = &(*ppsLink)->psNext;
+    }
+}
+
+/* Sets the compare channel for the head, in a critical section */
+static void HRT_vProgram(void)
+{
+    uint32 u32Now;
+    int32 i32Left;
+
+    if (psHrtHead == NULL)
+    {
+        PORTABLE_vHrtStopCompare();
+        return;
+    }
+
+    u32Now = HRT_u32Now();
+    i32Left = (int32)(psHrtHead->u32Deadline - u32Now);
+
+    if (i32Left < HRT_MIN_LEAD_US)
+    {
+        /* Due or nearly: interrupt as soon as it is safe, the ISR waits out the rest */
+        PORTABLE_vHrtSetCompare((uint16)(u32Now + HRT_MIN_LEAD_US));
+    }
+    else if (i32Left <= 0xFFFF)
+    {
+        /* The low half first matches at the deadline itself */
+        PORTABLE_vHrtSetCompare((uint16)psHrtHead->u32Deadline);
+    }
+    else
+    {
+        /* Beyond the counter range, an overflow interrupt comes first */
+        PORTABLE_vHrtStopCompare();
+    }
+}
+
+/* Runs the callbacks of the timers that are due and programs the next one */
+static void HRT_vService(void)
+{
+    uint8 u8State = PORTABLE_u8EnterCritical();
+    HRT_tsTimer *psTimer;
+
+    while (((psTimer = psHrtHead) != NULL) &&
+           ((int32)(psTimer->u32Deadline - HRT_u32Now()) <= HRT_MIN_LEAD_US))
+    {
+        /* Too close to program: wait out the last microseconds here */
+        while ((int32)(psTimer->u32Deadline - HRT_u32Now()) > 0)
+        {
+        }
+
+        psHrtHead = psTimer->psNext;
+        psTimer->bArmed = FALSE;
+
+        /* The callback may arm timers, including this one */
+        PORTABLE_vExitCritical(u8State);
+        psTimer->pfCallback(psTimer->pvParam);
+        u8State = PORTABLE_u8EnterCritical();
+    }
+
+    HRT_vProgram();
+
+    PORTABLE_vExitCritical(u8State);
+}
+
+#endif /* PORTABLE_SUPPORT_HRT */
+
+/****************************************************************************/
+/***        END OF FILE                                                   ***/
+/****************************************************************************/
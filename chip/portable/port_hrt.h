@@ -0,0 +1,81 @@
+/*****************************************************************************
+ *
+ * MODULE:             port_hrt
+ *
+ * COMPONENT:          port_hrt.h
+ *
+ * DESCRIPTION:        High resolution one-shot timers
+ *
+ ****************************************************************************
+ *
+ * This software is owned by NXP B.V. and/or its supplier and is protected
+ * under applicable copyright laws. All rights are reserved. We grant You,
+ * and any third parties, a license to use this software solely and
+ * exclusively on NXP products [NXP Microcontrollers such as JN5168, JN5179].
+ * You, and any third parties must reproduce the copyright and warranty notice
+ * and any other legend of ownership on each copy or partial copy of the
+ * software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Copyright NXP B.V. 2016. All rights reserved
+ *
+ ***************************************************************************/
+
+#ifndef PORT_HRT_H_
+#define PORT_HRT_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+/* Includes ------------------------------------------------------------------*/
+#include "chip_selection.h"
+/* Exported Define -----------------------------------------------------------*/
+/* A deadline closer than this is not programmed on the compare channel, which
+ * could be passed while being written; the ISR waits it out instead */
+#ifndef HRT_MIN_LEAD_US
+#if (defined STM32F10X_MD)
+#define HRT_MIN_LEAD_US           (4)
+#else
+#define HRT_MIN_LEAD_US           (20)
+#endif
+#endif
+/* Exported Typedefs ---------------------------------------------------------*/
+typedef void (*HRT_tpfCallback)(void *pvParam);
+/* Exported Structure Declarations -------------------------------------------*/
+/* One-shot timer owned by the caller, in static or zeroed storage. It is linked
+ * into the deadline sorted queue while armed and must not be reused until its
+ * callback ran or HRT_bCancel returned. */
+typedef struct HRT_tsTimer
+{
+    struct HRT_tsTimer  *psNext;        /* Next armed timer, later deadline */
+    uint32              u32Deadline;    /* HRT_u32Now value at which the callback runs */
+    HRT_tpfCallback     pfCallback;     /* Called from the TIM2 interrupt */
+    void                *pvParam;
+    bool_t              bArmed;
+} HRT_tsTimer;
+/* Exported Functions Declarations -------------------------------------------*/
+void HRT_vInit(void);
+uint32 HRT_u32Now(void);
+bool_t HRT_bStart(HRT_tsTimer *psTimer, uint32 u32Micros, HRT_tpfCallback pfCallback, void *pvParam);
+bool_t HRT_bStartAt(HRT_tsTimer *psTimer, uint32 u32Deadline, HRT_tpfCallback pfCallback, void *pvParam);
+bool_t HRT_bCancel(HRT_tsTimer *psTimer);
+bool_t HRT_bIsArmed(HRT_tsTimer *psTimer);
+void HRT_vIsrOverflow(void);
+void HRT_vIsrCompare(void);
+/* External Variable Declarations --------------------------------------------*/
+
+#ifdef __cplusplus
+}
+#endif
+#endif /*PORT_HRT_H_*/
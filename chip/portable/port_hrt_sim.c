@@ -0,0 +1,172 @@
+/*****************************************************************************
+ *
+ * MODULE:             port_hrt
+ *
+ * COMPONENT:          port_hrt_sim.c
+ *
+ * DESCRIPTION:        Host simulation of the high resolution timer hardware
+ *
+ * Stands in for the MCU port file when port_hrt.c is built on a PC with
+ * PORTABLE_HRT_SIMULATION. TIM2 is a 16 bit counter moved on by
+ * PORTABLE_vHrtSimAdvance; every counter read also takes one microsecond, so
+ * the waits in port_hrt.c end. The overflow and compare "interrupts" are
+ * delivered in counter order when the simulated interrupt mask is clear.
+ *
+ ****************************************************************************
+ *
+ * This software is owned by NXP B.V. and/or its supplier and is protected
+ * under applicable copyright laws. All rights are reserved. We grant You,
+ * and any third parties, a license to use this software solely and
+ * exclusively on NXP products [NXP Microcontrollers such as JN5168, JN5179].
+ * You, and any third parties must reproduce the copyright and warranty notice
+ * and any other legend of ownership on each copy or partial copy of the
+ * software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Copyright NXP B.V. 2016. All rights reserved
+ *
+ ***************************************************************************/
+
+/****************************************************************************/
+/***        Include files                                                 ***/
+/****************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "port_mcu.h"
+#include "port_hrt.h"
+
+#if (defined PORTABLE_SUPPORT_HRT) && (defined PORTABLE_HRT_SIMULATION)
+
+/****************************************************************************/
+/***        Local Function Prototypes                                     ***/
+/****************************************************************************/
+static void sim_tick(void);
+static void sim_dispatch(void);
+
+/****************************************************************************/
+/***        Local Variables                                               ***/
+/****************************************************************************/
+
+static uint16 u16SimCounter;
+static uint16 u16SimCompare;
+static bool_t bSimCompareEnabled;
+static bool_t bSimOverflowFlag;
+static bool_t bSimCompareFlag;
+static uint8 u8SimMasked;              /* Interrupt mask, also set while an interrupt runs */
+
+/****************************************************************************/
+/***        Exported Functions                                            ***/
+/****************************************************************************/
+
+uint8 PORTABLE_u8EnterCritical(void)
+{
+    uint8 u8State = u8SimMasked;
+
+    u8SimMasked = 1;
+    return u8State;
+}
+
+void PORTABLE_vExitCritical(uint8 u8State)
+{
+    u8SimMasked = u8State;
+    sim_dispatch();
+}
+
+void PORTABLE_vHrtInit(void)
+{
+    u16SimCounter = 0;
+    bSimCompareEnabled = FALSE;
+    bSimOverflowFlag = FALSE;
+    bSimCompareFlag = FALSE;
+    u8SimMasked = 0;
+}
+
+uint16 PORTABLE_u16HrtCounter(void)
+{
+    sim_tick();
+    return u16SimCounter;
+}
+
+bool_t PORTABLE_bHrtOverflowPending(void)
+{
+    return bSimOverflowFlag;
+}
+
+void PORTABLE_vHrtSetCompare(uint16 u16Compare)
+{
+    u16SimCompare = u16Compare;
+    bSimCompareFlag = FALSE;
+    bSimCompareEnabled = TRUE;
+}
+
+void PORTABLE_vHrtStopCompare(void)
+{
+    bSimCompareEnabled = FALSE;
+    bSimCompareFlag = FALSE;
+}
+
+/* Moves the simulated counter on, raising the interrupts it passes */
+void PORTABLE_vHrtSimAdvance(uint32 u32Micros)
+{
+    while (u32Micros-- > 0)
+    {
+        sim_tick();
+        sim_dispatch();
+    }
+}
+
+/****************************************************************************/
+/***        Local Functions                                               ***/
+/****************************************************************************/
+
+static void sim_tick(void)
+{
+    u16SimCounter++;
+
+    if (u16SimCounter == 0)
+    {
+        bSimOverflowFlag = TRUE;
+    }
+    if (u16SimCounter == u16SimCompare)
+    {
+        bSimCompareFlag = TRUE;
+    }
+}
+
+static void sim_dispatch(void)
+{
+    /* The update interrupt has the higher priority, as on the targets */
+    while (!u8SimMasked && (bSimOverflowFlag || (bSimCompareFlag && bSimCompareEnabled)))
+    {
+        u8SimMasked = 1;
+        if (bSimOverflowFlag)
+        {
+            bSimOverflowFlag = FALSE;
+            HRT_vIsrOverflow();
+        }
+        else
+        {
+            bSimCompareFlag = FALSE;
+            HRT_vIsrCompare();
+        }
+        u8SimMasked = 0;
+    }
+}
+
+#endif /* PORTABLE_SUPPORT_HRT && PORTABLE_HRT_SIMULATION */
+
+/****************************************************************************/
+/***        END OF FILE                                                   ***/
+/****************************************************************************/
@@ -40,11 +40,84 @@
  extern "C" {
 #endif
 /* Includes ------------------------------------------------------------------*/
+#include "chip_selection.h"
 /* Exported Define -----------------------------------------------------------*/
+#if ((defined TIMER_SUPPORT_PROFILING) || (defined DEFER_SUPPORT_STATISTICS)) && (defined STM32F10X_MD)
+/* The port has a free running core cycle counter for the timer profiling and
+ * the handler durations of Defer.c */
+#define PORTABLE_SUPPORT_CYCLE_COUNTER
+#define PORTABLE_CYCLES_PER_TICK    (SystemCoreClock / 1000)
+#endif
+/* Idle modes of PORTABLE_vIdle, lightest first (PWRM_teMode in PowerManager.h) */
+#define PORTABLE_IDLE_SLEEP         1
+#define PORTABLE_IDLE_STOP          2
+#define PORTABLE_IDLE_STANDBY       3
 /* Exported Typedefs ---------------------------------------------------------*/
 /* Exported Structure Declarations -------------------------------------------*/
 /* Exported Functions Declarations -------------------------------------------*/
 void PORTABLE_vInit(void);
+void PORTABLE_vDisableInterrupts(void);
+void PORTABLE_vEnableInterrupts(void);
+/* Critical section that may be entered from an ISR or with interrupts already
+ * disabled: Exit restores the interrupt mask Enter returned. */
+uint8 PORTABLE_u8EnterCritical(void);
+void PORTABLE_vExitCritical(uint8 u8State);
+/* Must be called with interrupts disabled; sleeps until an interrupt is pending
+ * and returns with interrupts enabled, so a wake-up can not be missed between
+ * the caller's last check and the sleep. u8Mode is a PORTABLE_IDLE_ mode: SLEEP
+ * keeps every clock running, STOP and STANDBY stop the tick timer and the
+ * peripheral clocks and only an external interrupt (or the RTC) wakes them.
+ * STANDBY on Cortex-M loses the RAM and wakes through a reset. */
+void PORTABLE_vIdle(uint8 u8Mode);
+/* Microseconds gone in the current 1 ms tick, from the time base counter. A
+ * tick that has elapsed but whose interrupt has not run yet adds 1000, so the
+ * result always follows the tick count ISR_vTickTimer has reached. Not valid
+ * while the time base is stretched. */
+uint16 PORTABLE_u16TimebaseMicros(void);
+#ifdef TIMER_SUPPORT_TICKLESS
+/* Tickless idle, both called with interrupts disabled. Stretch makes the next
+ * time base interrupt come u32Ticks tick boundaries from now (or as far as the
+ * hardware allows) and returns FALSE when it did not stretch. Restore ends the
+ * stretch, returns the ticks that went by and were not reported through
+ * ISR_vTickTimer (bTickReported: the stretch interrupt already ran) and goes
+ * back to the normal tick, in phase with the ticks before the stretch. */
+bool_t PORTABLE_bTimebaseStretch(uint32 u32Ticks);
+uint32 PORTABLE_u32TimebaseRestore(bool_t bTickReported);
+#endif
+#ifdef PORTABLE_SUPPORT_HRT
+/* High resolution timer hardware for port_hrt.c: TIM2 as a free running 16 bit
+ * counter at 1 MHz with compare channel 1. The TIM2 update and compare
+ * interrupts clear their flag and call HRT_vIsrOverflow / HRT_vIsrCompare.
+ * OverflowPending tells an overflow whose interrupt has not run yet. */
+void PORTABLE_vHrtInit(void);
+uint16 PORTABLE_u16HrtCounter(void);
+bool_t PORTABLE_bHrtOverflowPending(void);
+void PORTABLE_vHrtSetCompare(uint16 u16Compare);
+void PORTABLE_vHrtStopCompare(void);
+#ifdef PORTABLE_HRT_SIMULATION
+/* Host simulation only (port_hrt_sim.c): time passing on the simulated TIM2 */
+void PORTABLE_vHrtSimAdvance(uint32 u32Micros);
+#endif
+#endif
+#ifdef PORTABLE_SUPPORT_CYCLE_COUNTER
+/* Core clock cycles, wraps every 2^32; started by PORTABLE_vInit */
+uint32 PORTABLE_u32CycleCounter(void);
+#endif
+#ifdef PORTABLE_SUPPORT_RTOS
+/* Context switching for the kernel in components/rtos (port_os_cortexm.c, or
+ * port_os_posix.c on a host with PORTABLE_RTOS_POSIX). InitThread prepares a
+ * new thread to start at its function on its stack. Switch requests a switch
+ * from OS_psCurrent to OS_psNext, taken once interrupts are enabled and no
+ * other interrupt runs. Start makes the first switch, with interrupts disabled
+ * and nothing to save, and does not return. */
+struct os_thread_cb;
+void PORTABLE_vOsInitThread(struct os_thread_cb *psThread);
+void PORTABLE_vOsStart(void);
+void PORTABLE_vOsSwitch(void);
+bool_t PORTABLE_bOsInIsr(void);
+/* Loop body of the idle thread */
+void PORTABLE_vOsIdle(void);
+#endif
 /* External Variable Declarations --------------------------------------------*/
 
 #ifdef __cplusplus
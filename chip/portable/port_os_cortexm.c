@@ -0,0 +1,170 @@
+/*****************************************************************************
+ *
+ * MODULE:             port_os
+ *
+ * COMPONENT:          port_os_cortexm.c
+ *
+ * DESCRIPTION:        Cortex-M0/M3 context switch for the kernel
+ *
+ * Threads run in thread mode on the process stack, interrupts on the main
+ * stack. A switch is made in PendSV at the lowest priority, so it is taken
+ * after every other interrupt and never inside a critical section. Only
+ * Thumb-1 instructions are used, the same code runs on Cortex-M0. The 1 ms
+ * tick stays the SysTick of the port file, whose handler calls OS_vTick.
+ * PendSV is written here for GCC and in port_os_cortexm_iar.s for IAR.
+ *
+ ****************************************************************************
+ *
+ * This software is owned by NXP B.V. and/or its supplier and is protected
+ * under applicable copyright laws. All rights are reserved. We grant You,
+ * and any third parties, a license to use this software solely and
+ * exclusively on NXP products [NXP Microcontrollers such as JN5168, JN5179].
+ * You, and any third parties must reproduce the copyright and warranty notice
+ * and any other legend of ownership on each copy or partial copy of the
+ * software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Copyright NXP B.V. 2016. All rights reserved
+ *
+ ***************************************************************************/
+
+/****************************************************************************/
+/***        Include files                                                 ***/
+/****************************************************************************/
+
+#include "port_mcu.h"
+#include "chip_selection.h"
+#include "cmsis_os.h"
+
+#if (defined PORTABLE_SUPPORT_RTOS) && !(defined PORTABLE_RTOS_POSIX)
+
+/****************************************************************************/
+/***        Macro Definitions                                             ***/
+/****************************************************************************/
+
+/* Frame a switched out thread leaves on its stack, from the saved stack
+ * pointer up: R4-R7, R8-R11 by PendSV, then R0-R3, R12, LR, PC, xPSR by the
+ * exception entry */
+#define PORT_OS_FRAME_WORDS       (16)
+#define PORT_OS_FRAME_R0          (8)
+#define PORT_OS_FRAME_LR          (13)
+#define PORT_OS_FRAME_PC          (14)
+#define PORT_OS_FRAME_XPSR        (15)
+
+#define PORT_OS_XPSR_THUMB        (0x01000000UL)
+
+/****************************************************************************/
+/***        Exported Functions                                            ***/
+/****************************************************************************/
+
+void PORTABLE_vOsInitThread(struct os_thread_cb *psThread)
+{
+    uint32 *pu32Sp = psThread->pu32Stack + psThread->u32StackWords;
+    uint8 u8Word;
+
+    /* The exception frame is 8 byte aligned */
+    pu32Sp = (uint32 *)((uint32)pu32Sp & ~7UL) - PORT_OS_FRAME_WORDS;
+    for (u8Word = 0; u8Word < PORT_OS_FRAME_WORDS; u8Word++)
+    {
+        pu32Sp[u8Word] = 0;
+    }
+
+    /* The first switch "returns" into the thread function, which returns
+       into OS_vThreadReturn */
+    pu32Sp[PORT_OS_FRAME_R0] = (uint32)psThread->pvArgument;
+    pu32Sp[PORT_OS_FRAME_LR] = (uint32)OS_vThreadReturn;
+    pu32Sp[PORT_OS_FRAME_PC] = (uint32)psThread->pfThread & ~1UL;
+    pu32Sp[PORT_OS_FRAME_XPSR] = PORT_OS_XPSR_THUMB;
+
+    psThread->pu32Sp = pu32Sp;
+}
+
+void PORTABLE_vOsStart(void)
+{
+    /* The main stack is left for the interrupts from here on */
+    NVIC_SetPriority(PendSV_IRQn, (1UL << __NVIC_PRIO_BITS) - 1);
+    OS_psCurrent = NULL;
+    PORTABLE_vOsSwitch();
+    __enable_irq();
+
+    for (;;)
+    {
+    }
+}
+
+void PORTABLE_vOsSwitch(void)
+{
+    SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+}
+
+bool_t PORTABLE_bOsInIsr(void)
+{
+    return (bool_t)((SCB->ICSR & SCB_ICSR_VECTACTIVE_Msk) != 0);
+}
+
+void PORTABLE_vOsIdle(void)
+{
+    __WFI();
+}
+
+#if (defined __GNUC__)
+/* Saves R4-R11 below the frame of OS_psCurrent (nothing for the first
+ * switch), makes OS_psNext current and returns into it on the process stack */
+void PendSV_Handler(void) __attribute__((naked));
+void PendSV_Handler(void)
+{
+    __asm volatile(
+        "   cpsid   i                   \n"
+        "   ldr     r3, 1f              \n"
+        "   ldr     r1, [r3]            \n"
+        "   cmp     r1, #0              \n"
+        "   beq     2f                  \n"
+        "   mrs     r0, psp             \n"
+        "   subs    r0, r0, #32         \n"
+        "   str     r0, [r1]            \n"
+        "   stmia   r0!, {r4-r7}        \n"
+        "   mov     r4, r8              \n"
+        "   mov     r5, r9              \n"
+        "   mov     r6, r10             \n"
+        "   mov     r7, r11             \n"
+        "   stmia   r0!, {r4-r7}        \n"
+        "2: ldr     r2, 3f              \n"
+        "   ldr     r1, [r2]            \n"
+        "   str     r1, [r3]            \n"
+        "   ldr     r0, [r1]            \n"
+        "   adds    r0, r0, #16         \n"
+        "   ldmia   r0!, {r4-r7}        \n"
+        "   mov     r8, r4              \n"
+        "   mov     r9, r5              \n"
+        "   mov     r10, r6             \n"
+        "   mov     r11, r7             \n"
+        "   msr     psp, r0             \n"
+        "   subs    r0, r0, #32         \n"
+        "   ldmia   r0!, {r4-r7}        \n"
+        "   ldr     r0, 4f              \n"
+        "   cpsie   i                   \n"
+        "   bx      r0                  \n"
+        "   .align  2                   \n"
+        "1: .word   OS_psCurrent        \n"
+        "3: .word   OS_psNext           \n"
+        "4: .word   0xFFFFFFFD          \n"
+    );
+}
+#endif
+
+#endif /* PORTABLE_SUPPORT_RTOS && !PORTABLE_RTOS_POSIX */
+
+/****************************************************************************/
+/***        END OF FILE                                                   ***/
+/****************************************************************************/
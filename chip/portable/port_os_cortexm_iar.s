@@ -0,0 +1,88 @@
+/*****************************************************************************
+ *
+ * MODULE:             port_os
+ *
+ * COMPONENT:          port_os_cortexm_iar.s
+ *
+ * DESCRIPTION:        PendSV context switch for the kernel, IAR assembler
+ *
+ * Same switch as the GCC one in port_os_cortexm.c: saves R4-R11 below the
+ * frame of OS_psCurrent (nothing for the first switch), makes OS_psNext
+ * current and returns into it on the process stack. Thumb-1 only, for
+ * Cortex-M0 and M3. Only add it to projects built with PORTABLE_SUPPORT_RTOS,
+ * it replaces the PendSV_Handler of the interrupt file.
+ *
+ ****************************************************************************
+ *
+ * This software is owned by NXP B.V. and/or its supplier and is protected
+ * under applicable copyright laws. All rights are reserved. We grant You,
+ * and any third parties, a license to use this software solely and
+ * exclusively on NXP products [NXP Microcontrollers such as JN5168, JN5179].
+ * You, and any third parties must reproduce the copyright and warranty notice
+ * and any other legend of ownership on each copy or partial copy of the
+ * software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Copyright NXP B.V. 2016. All rights reserved
+ *
+ ***************************************************************************/
+
+        MODULE  port_os_cortexm_iar
+
+        PUBLIC  PendSV_Handler
+        EXTERN  OS_psCurrent
+        EXTERN  OS_psNext
+
+        SECTION .text:CODE:NOROOT(2)
+        THUMB
+
+PendSV_Handler:
+        CPSID   I
+        LDR     R3, =OS_psCurrent
+        LDR     R1, [R3]
+        CMP     R1, #0
+        BEQ     PendSV_Restore
+
+        /* Save R4-R11 below the exception frame, the stack pointer first */
+        MRS     R0, PSP
+        SUBS    R0, R0, #32
+        STR     R0, [R1]
+        STMIA   R0!, {R4-R7}
+        MOV     R4, R8
+        MOV     R5, R9
+        MOV     R6, R10
+        MOV     R7, R11
+        STMIA   R0!, {R4-R7}
+
+PendSV_Restore:
+        LDR     R2, =OS_psNext
+        LDR     R1, [R2]
+        STR     R1, [R3]
+        LDR     R0, [R1]
+        ADDS    R0, R0, #16
+        LDMIA   R0!, {R4-R7}
+        MOV     R8, R4
+        MOV     R9, R5
+        MOV     R10, R6
+        MOV     R11, R7
+        MSR     PSP, R0
+        SUBS    R0, R0, #32
+        LDMIA   R0!, {R4-R7}
+
+        /* Thread mode on the process stack */
+        LDR     R0, =0xFFFFFFFD
+        CPSIE   I
+        BX      R0
+
+        END
@@ -0,0 +1,269 @@
+/*****************************************************************************
+ *
+ * MODULE:             port_os
+ *
+ * COMPONENT:          port_os_posix.c
+ *
+ * DESCRIPTION:        Host port of the kernel on POSIX threads
+ *
+ * Stands in for the MCU port file and port_os_cortexm.c when the kernel is
+ * built on a PC with PORTABLE_RTOS_POSIX, so that code written against
+ * cmsis_os.h can be run and tested off target. Every kernel thread is a host
+ * thread, of which only OS_psCurrent is let run. The interrupt mask is a
+ * recursive mutex; a tick thread takes it every millisecond to call
+ * ISR_vTickTimer and OS_vTick, like the SysTick interrupt. A switch is taken
+ * when the running thread leaves its outermost critical section, so a thread
+ * is only preempted when it calls the kernel: one spinning in a loop of its own
+ * keeps the CPU, which the targets would take from it.
+ *
+ ****************************************************************************
+ *
+ * This software is owned by NXP B.V. and/or its supplier and is protected
+ * under applicable copyright laws. All rights are reserved. We grant You,
+ * and any third parties, a license to use this software solely and
+ * exclusively on NXP products [NXP Microcontrollers such as JN5168, JN5179].
+ * You, and any third parties must reproduce the copyright and warranty notice
+ * and any other legend of ownership on each copy or partial copy of the
+ * software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Copyright NXP B.V. 2016. All rights reserved
+ *
+ ***************************************************************************/
+
+/****************************************************************************/
+/***        Include files                                                 ***/
+/****************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include "port_mcu.h"
+#include "cmsis_os.h"
+
+#if (defined PORTABLE_SUPPORT_RTOS) && (defined PORTABLE_RTOS_POSIX)
+
+/****************************************************************************/
+/***        Type Definitions                                              ***/
+/****************************************************************************/
+
+typedef struct
+{
+    pthread_t           tThread;
+    sem_t               sRun;           /* Posted when the thread is to run */
+} tsPosixThread;
+
+/****************************************************************************/
+/***        Local Function Prototypes                                     ***/
+/****************************************************************************/
+static void posix_init(void);
+static void *posix_thread(void *pvParam);
+static void *posix_tick(void *pvParam);
+
+/****************************************************************************/
+/***        Local Variables                                               ***/
+/****************************************************************************/
+
+static pthread_once_t tPosixOnce = PTHREAD_ONCE_INIT;
+static pthread_mutex_t sPosixMask;      /* Held while "interrupts are disabled" */
+static uint32 u32PosixDepth;            /* Critical section nesting of the holder */
+static bool_t bPosixSwitch;             /* Switch requested, not taken yet */
+static __thread bool_t bPosixInIsr;     /* Set in the tick thread */
+static struct timespec sPosixStart;
+
+/****************************************************************************/
+/***        Exported Functions                                            ***/
+/****************************************************************************/
+
+uint8 PORTABLE_u8EnterCritical(void)
+{
+    pthread_once(&tPosixOnce, posix_init);
+    pthread_mutex_lock(&sPosixMask);
+
+    return (uint8)(u32PosixDepth++ != 0);
+}
+
+/* Leaving the outermost section hands the CPU over when a switch is pending:
+   the next thread is let go and this one waits until it is chosen again */
+void PORTABLE_vExitCritical(uint8 u8State)
+{
+    tsPosixThread *psPrev;
+    tsPosixThread *psNext;
+
+    (void)u8State;
+
+    if (--u32PosixDepth == 0 && bPosixSwitch && !bPosixInIsr)
+    {
+        bPosixSwitch = FALSE;
+        psPrev = (tsPosixThread *)OS_psCurrent->pvPort;
+        psNext = (tsPosixThread *)OS_psNext->pvPort;
+        OS_psCurrent = OS_psNext;
+        pthread_mutex_unlock(&sPosixMask);
+
+        if (psNext != psPrev)
+        {
+            sem_post(&psNext->sRun);
+            sem_wait(&psPrev->sRun);
+        }
+        return;
+    }
+
+    pthread_mutex_unlock(&sPosixMask);
+}
+
+/* Interrupts disabled is the outermost critical section held, for the code
+   outside the kernel that expects it (the power manager) */
+void PORTABLE_vDisableInterrupts(void)
+{
+    (void)PORTABLE_u8EnterCritical();
+}
+
+void PORTABLE_vEnableInterrupts(void)
+{
+    PORTABLE_vExitCritical(0);
+}
+
+/* Called with interrupts disabled, returns with them enabled */
+void PORTABLE_vIdle(uint8 u8Mode)
+{
+    (void)u8Mode;
+
+    PORTABLE_vEnableInterrupts();
+    usleep(100);
+}
+
+/* Microseconds since the last whole millisecond of the host clock, which the
+   tick thread only roughly follows */
+uint16 PORTABLE_u16TimebaseMicros(void)
+{
+    struct timespec sNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &sNow);
+    return (uint16)((sNow.tv_nsec / 1000) % 1000);
+}
+
+void PORTABLE_vOsInitThread(struct os_thread_cb *psThread)
+{
+    tsPosixThread *psPosix = (tsPosixThread *)malloc(sizeof(tsPosixThread));
+
+    /* A terminated host thread waits on its old semaphore for ever */
+    sem_init(&psPosix->sRun, 0, 0);
+    psThread->pvPort = psPosix;
+    pthread_create(&psPosix->tThread, NULL, posix_thread, psThread);
+}
+
+/* Called in a critical section, which ends here. The calling thread (main)
+   is not a kernel thread and only sleeps from now on. */
+void PORTABLE_vOsStart(void)
+{
+    pthread_t tTick;
+
+    OS_psCurrent = OS_psNext;
+    bPosixSwitch = FALSE;
+    u32PosixDepth = 0;
+    clock_gettime(CLOCK_MONOTONIC, &sPosixStart);
+    pthread_mutex_unlock(&sPosixMask);
+
+    pthread_create(&tTick, NULL, posix_tick, NULL);
+    sem_post(&((tsPosixThread *)OS_psCurrent->pvPort)->sRun);
+
+    for (;;)
+    {
+        pause();
+    }
+}
+
+void PORTABLE_vOsSwitch(void)
+{
+    bPosixSwitch = TRUE;
+}
+
+bool_t PORTABLE_bOsInIsr(void)
+{
+    return bPosixInIsr;
+}
+
+/* Gives the host CPU away, then takes a switch the tick may have requested */
+void PORTABLE_vOsIdle(void)
+{
+    uint8 u8State;
+
+    usleep(100);
+    u8State = PORTABLE_u8EnterCritical();
+    PORTABLE_vExitCritical(u8State);
+}
+
+/****************************************************************************/
+/***        Local Functions                                               ***/
+/****************************************************************************/
+
+static void posix_init(void)
+{
+    pthread_mutexattr_t sAttr;
+
+    pthread_mutexattr_init(&sAttr);
+    pthread_mutexattr_settype(&sAttr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&sPosixMask, &sAttr);
+    pthread_mutexattr_destroy(&sAttr);
+}
+
+static void *posix_thread(void *pvParam)
+{
+    struct os_thread_cb *psThread = (struct os_thread_cb *)pvParam;
+
+    sem_wait(&((tsPosixThread *)psThread->pvPort)->sRun);
+    psThread->pfThread(psThread->pvArgument);
+    OS_vThreadReturn();
+
+    return NULL;
+}
+
+/* The SysTick interrupt, on absolute 1 ms deadlines so that ticks are not
+   lost to the scheduling of the host */
+static void *posix_tick(void *pvParam)
+{
+    struct timespec sNext = sPosixStart;
+    uint8 u8State;
+
+    (void)pvParam;
+    bPosixInIsr = TRUE;
+
+    for (;;)
+    {
+        sNext.tv_nsec += 1000000;
+        if (sNext.tv_nsec >= 1000000000)
+        {
+            sNext.tv_nsec -= 1000000000;
+            sNext.tv_sec++;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &sNext, NULL);
+
+        u8State = PORTABLE_u8EnterCritical();
+        ISR_vTickTimer();
+        OS_vTick();
+        PORTABLE_vExitCritical(u8State);
+    }
+
+    return NULL;
+}
+
+#endif /* PORTABLE_SUPPORT_RTOS && PORTABLE_RTOS_POSIX */
+
+/****************************************************************************/
+/***        END OF FILE                                                   ***/
+/****************************************************************************/
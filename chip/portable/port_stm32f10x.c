@@ -35,6 +35,22 @@
 /***        Macro Definitions                                             ***/
 /****************************************************************************/
 
+#define PORT_TICK_CYCLES          (SystemCoreClock / 1000)
+
+#ifdef TIMER_SUPPORT_TICKLESS
+/* Shortest first period PORTABLE_u32TimebaseRestore programs: it must outlast
+ * the writes from enabling SysTick to setting the tick reload value, flash
+ * wait states included, or SysTick reloads the short value once more */
+#define PORT_RESTORE_MIN_CYCLES   (32)
+#endif
+
+#ifdef PORTABLE_SUPPORT_CYCLE_COUNTER
+/* DWT cycle counter, not described by this CMSIS version */
+#define PORT_DWT_CTRL             (*(volatile uint32 *)0xE0001000UL)
+#define PORT_DWT_CYCCNT           (*(volatile uint32 *)0xE0001004UL)
+#define PORT_DWT_CTRL_CYCCNTENA   (1UL << 0)
+#endif
+
 /****************************************************************************/
 /***        Type Definitions                                              ***/
 /****************************************************************************/
@@ -55,6 +71,11 @@ static void timebase_initialize(void);
 /***        Local Variables                                               ***/
 /****************************************************************************/
 
+#ifdef TIMER_SUPPORT_TICKLESS
+static uint32 u32StretchLoad;          /* SysTick reload value of the stretched period */
+static uint32 u32StretchOffset;        /* Cycles of the current tick gone when the stretch started */
+#endif
+
 /****************************************************************************/
 /***        Exported Functions                                            ***/
 /****************************************************************************/
@@ -63,9 +84,236 @@ void PORTABLE_vInit(void)
     SystemInit();
     SystemCoreClockUpdate();
 
+#ifdef PORTABLE_SUPPORT_CYCLE_COUNTER
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    PORT_DWT_CYCCNT = 0;
+    PORT_DWT_CTRL |= PORT_DWT_CTRL_CYCCNTENA;
+#endif
+
     timebase_initialize();
 }
 
+void PORTABLE_vDisableInterrupts(void)
+{
+    __disable_irq();
+}
+
+void PORTABLE_vEnableInterrupts(void)
+{
+    __enable_irq();
+}
+
+uint8 PORTABLE_u8EnterCritical(void)
+{
+    uint8 u8State = (uint8)__get_PRIMASK();
+
+    __disable_irq();
+    return u8State;
+}
+
+void PORTABLE_vExitCritical(uint8 u8State)
+{
+    __set_PRIMASK(u8State);
+}
+
+void PORTABLE_vIdle(uint8 u8Mode)
+{
+    /* WFI wakes on a pending interrupt even while PRIMASK masks it; the
+       interrupt is then taken as soon as PRIMASK is cleared. Only EXTI lines
+       (the RTC alarm is EXTI 17) wake the core from STOP. */
+    if (u8Mode == PORTABLE_IDLE_SLEEP)
+    {
+        __WFI();
+    }
+    else
+    {
+        RCC_APB1PeriphClockCmd(RCC_APB1Periph_PWR, ENABLE);
+        if (u8Mode == PORTABLE_IDLE_STOP)
+        {
+            PWR_EnterSTOPMode(PWR_Regulator_LowPower, PWR_STOPEntry_WFI);
+
+            /* The core wakes up on HSI, the PLL has to be set up again */
+            SystemInit();
+        }
+        else
+        {
+            PWR_EnterSTANDBYMode();
+        }
+    }
+    __enable_irq();
+}
+
+uint16 PORTABLE_u16TimebaseMicros(void)
+{
+    uint32 u32TickCycles = PORT_TICK_CYCLES;
+    uint32 u32Val = SysTick->VAL;
+    uint16 u16Micros = 0;
+
+    /* The counter wrapped but the tick interrupt has not run: read it again
+       past the wrap and count the pending tick */
+    if ((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0)
+    {
+        u32Val = SysTick->VAL;
+        u16Micros = 1000;
+    }
+
+    /* A first period after a restore can also be longer, by the boundary
+       counted as passed while it was too close to program: until that
+       boundary is reached no time has gone in the tick */
+    if (u32Val > u32TickCycles - 1)
+    {
+        u32Val = u32TickCycles - 1;
+    }
+
+    /* SysTick counts down to the tick boundary; right after a restore the
+       first period is shorter, so the tick length is taken from the clock
+       rather than from LOAD */
+    return (uint16)(u16Micros + (((u32TickCycles - 1 - u32Val) * 1000) / u32TickCycles));
+}
+
+#ifdef PORTABLE_SUPPORT_CYCLE_COUNTER
+uint32 PORTABLE_u32CycleCounter(void)
+{
+    return PORT_DWT_CYCCNT;
+}
+#endif
+
+#ifdef PORTABLE_SUPPORT_HRT
+void PORTABLE_vHrtInit(void)
+{
+    TIM_TimeBaseInitTypeDef sTimeBase;
+    NVIC_InitTypeDef sNvic;
+
+    RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM2, ENABLE);
+
+    /* 1 us counts over the full 16 bit range. TIM2 runs from PCLK1 x2, which
+       is the core clock with the usual APB1 prescaler of 2 */
+    TIM_TimeBaseStructInit(&sTimeBase);
+    sTimeBase.TIM_Prescaler = (uint16_t)((SystemCoreClock / 1000000) - 1);
+    sTimeBase.TIM_Period = 0xFFFF;
+    TIM_TimeBaseInit(TIM2, &sTimeBase);
+    TIM_ClearFlag(TIM2, TIM_FLAG_Update | TIM_FLAG_CC1);
+    TIM_ITConfig(TIM2, TIM_IT_Update, ENABLE);
+
+    sNvic.NVIC_IRQChannel = TIM2_IRQn;
+    sNvic.NVIC_IRQChannelPreemptionPriority = 0;
+    sNvic.NVIC_IRQChannelSubPriority = 0;
+    sNvic.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&sNvic);
+
+    TIM_Cmd(TIM2, ENABLE);
+}
+
+uint16 PORTABLE_u16HrtCounter(void)
+{
+    return (uint16)TIM_GetCounter(TIM2);
+}
+
+bool_t PORTABLE_bHrtOverflowPending(void)
+{
+    return (bool_t)(TIM_GetFlagStatus(TIM2, TIM_FLAG_Update) != RESET);
+}
+
+void PORTABLE_vHrtSetCompare(uint16 u16Compare)
+{
+    TIM_SetCompare1(TIM2, u16Compare);
+    TIM_ClearFlag(TIM2, TIM_FLAG_CC1);
+    TIM_ITConfig(TIM2, TIM_IT_CC1, ENABLE);
+}
+
+void PORTABLE_vHrtStopCompare(void)
+{
+    TIM_ITConfig(TIM2, TIM_IT_CC1, DISABLE);
+    TIM_ClearFlag(TIM2, TIM_FLAG_CC1);
+}
+#endif
+
+#ifdef TIMER_SUPPORT_TICKLESS
+bool_t PORTABLE_bTimebaseStretch(uint32 u32Ticks)
+{
+    uint32 u32TickCycles = PORT_TICK_CYCLES;
+    uint32 u32Left;
+
+    /* The 24 bit reload value limits the stretch, 233 ms at 72 MHz */
+    if (u32Ticks > ((SysTick_LOAD_RELOAD_Msk + 1) / u32TickCycles))
+    {
+        u32Ticks = (SysTick_LOAD_RELOAD_Msk + 1) / u32TickCycles;
+    }
+    if (u32Ticks < 2)
+    {
+        return FALSE;
+    }
+
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+
+    /* A tick is already due, it must be counted first */
+    if ((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0)
+    {
+        SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+        return FALSE;
+    }
+
+    /* The stretched period ends on a tick boundary */
+    u32Left = SysTick->VAL;
+    u32StretchOffset = u32TickCycles - u32Left;
+    u32StretchLoad = u32Left + ((u32Ticks - 1) * u32TickCycles) - 1;
+
+    SysTick->LOAD = u32StretchLoad;
+    SysTick->VAL = 0;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+
+    return TRUE;
+}
+
+uint32 PORTABLE_u32TimebaseRestore(bool_t bTickReported)
+{
+    uint32 u32TickCycles = PORT_TICK_CYCLES;
+    uint32 u32Cycles;
+    uint32 u32Left;
+    uint32 u32Ticks;
+    bool_t bPending;
+
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+    bPending = ((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0);
+
+    /* Cycles since the start of the tick the stretch began in */
+    u32Cycles = u32StretchOffset + (SysTick->LOAD - SysTick->VAL);
+    if (bTickReported || bPending)
+    {
+        u32Cycles += u32StretchLoad + 1;
+    }
+    u32Ticks = u32Cycles / u32TickCycles;
+    u32Left = u32TickCycles - (u32Cycles % u32TickCycles);
+
+    /* The interrupt ending the stretch counts as one of the ticks */
+    if (bPending)
+    {
+        SCB->ICSR = SCB_ICSR_PENDSTCLR_Msk;
+    }
+    else if (bTickReported)
+    {
+        u32Ticks--;
+    }
+
+    /* A boundary too close to program is taken as passed, the first period
+       then runs on to the boundary after it */
+    if (u32Left < PORT_RESTORE_MIN_CYCLES)
+    {
+        u32Ticks++;
+        u32Left += u32TickCycles;
+    }
+
+    /* The first period only runs to the next tick boundary; the new reload
+       value is picked up by the counter from the following period on */
+    SysTick->LOAD = u32Left - 1;
+    SysTick->VAL = 0;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+    SysTick->LOAD = u32TickCycles - 1;
+
+    return u32Ticks;
+}
+#endif
+
 /****************************************************************************/
 /***        Local Function                                                ***/
 /****************************************************************************/
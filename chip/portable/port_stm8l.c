@@ -35,6 +35,17 @@
 /***        Macro Definitions                                             ***/
 /****************************************************************************/
 
+/* TIM4 runs 8 us counts (prescaler 128), 125 of them make the 1 ms tick */
+#define PORT_TICK_UNITS           (125)
+#define PORT_UNIT_MICROS          (8)
+
+#ifdef TIMER_SUPPORT_TICKLESS
+/* While stretched the prescaler is 32768, one count is 256 units of 8 us, so a
+   single period covers up to 524 ms */
+#define PORT_STRETCH_UNITS        (256)
+#define PORT_STRETCH_MAX_TICKS    ((256UL * PORT_STRETCH_UNITS) / PORT_TICK_UNITS)
+#endif
+
 /****************************************************************************/
 /***        Type Definitions                                              ***/
 /****************************************************************************/
@@ -55,6 +66,11 @@ static void timebase_initialize(void);
 /***        Local Variables                                               ***/
 /****************************************************************************/
 
+#ifdef TIMER_SUPPORT_TICKLESS
+static uint8 u8StretchPhase;           /* TIM4 counts of the current tick gone when the stretch started */
+static uint16 u16StretchCounts;        /* Length of the stretched period in stretch counts */
+#endif
+
 /****************************************************************************/
 /***        Exported Functions                                            ***/
 /****************************************************************************/
@@ -67,6 +83,180 @@ void PORTABLE_vInit(void)
   timebase_initialize();
 }
 
+void PORTABLE_vDisableInterrupts(void)
+{
+  disableInterrupts();
+}
+
+void PORTABLE_vEnableInterrupts(void)
+{
+  enableInterrupts();
+}
+
+uint8 PORTABLE_u8EnterCritical(void)
+{
+  uint8 u8State = (uint8)__get_interrupt_state();
+
+  disableInterrupts();
+  return u8State;
+}
+
+void PORTABLE_vExitCritical(uint8 u8State)
+{
+  __set_interrupt_state((__istate_t)u8State);
+}
+
+void PORTABLE_vIdle(uint8 u8Mode)
+{
+  /* WFI and HALT clear the interrupt mask themselves, so an interrupt that is
+     already pending wakes the core at once. STOP keeps the main regulator on
+     for a fast wake-up; STANDBY lets it and the internal reference go off.
+     The halt is an Active-Halt when the application keeps the RTC clocked. */
+  if (u8Mode == PORTABLE_IDLE_SLEEP)
+  {
+    wfi();
+  }
+  else
+  {
+    PWR_UltraLowPowerCmd((u8Mode == PORTABLE_IDLE_STANDBY) ? ENABLE : DISABLE);
+    CLK_HaltConfig(CLK_Halt_SlowWakeup, (u8Mode == PORTABLE_IDLE_STANDBY) ? ENABLE : DISABLE);
+    halt();
+  }
+  enableInterrupts();
+}
+
+uint16 PORTABLE_u16TimebaseMicros(void)
+{
+  uint8 u8Counts = TIM4_GetCounter();
+
+  /* The counter wrapped but the tick interrupt has not run: read it again
+     past the wrap and count the pending tick */
+  if (TIM4_GetFlagStatus(TIM4_FLAG_Update) != RESET)
+  {
+    u8Counts = TIM4_GetCounter();
+    return (uint16)(1000 + ((uint16)u8Counts * PORT_UNIT_MICROS));
+  }
+
+  return (uint16)((uint16)u8Counts * PORT_UNIT_MICROS);
+}
+
+#ifdef PORTABLE_SUPPORT_HRT
+void PORTABLE_vHrtInit(void)
+{
+  CLK_PeripheralClockConfig(CLK_Peripheral_TIM2, ENABLE);
+
+  /* 16 MHz / 16: 1 us counts over the full 16 bit range */
+  TIM2_TimeBaseInit(TIM2_Prescaler_16, TIM2_CounterMode_Up, 0xFFFF);
+  TIM2_ClearFlag(TIM2_FLAG_Update);
+  TIM2_ITConfig(TIM2_IT_Update, ENABLE);
+  TIM2_Cmd(ENABLE);
+}
+
+uint16 PORTABLE_u16HrtCounter(void)
+{
+  return TIM2_GetCounter();
+}
+
+bool_t PORTABLE_bHrtOverflowPending(void)
+{
+  return (bool_t)(TIM2_GetFlagStatus(TIM2_FLAG_Update) != RESET);
+}
+
+void PORTABLE_vHrtSetCompare(uint16 u16Compare)
+{
+  TIM2_SetCompare1(u16Compare);
+  TIM2_ClearFlag(TIM2_FLAG_CC1);
+  TIM2_ITConfig(TIM2_IT_CC1, ENABLE);
+}
+
+void PORTABLE_vHrtStopCompare(void)
+{
+  TIM2_ITConfig(TIM2_IT_CC1, DISABLE);
+  TIM2_ClearFlag(TIM2_FLAG_CC1);
+}
+#endif
+
+#ifdef TIMER_SUPPORT_TICKLESS
+bool_t PORTABLE_bTimebaseStretch(uint32 u32Ticks)
+{
+  uint32 u32Units;
+
+  TIM4_Cmd(DISABLE);
+
+  /* A tick is already due, it must be counted first */
+  if (TIM4_GetFlagStatus(TIM4_FLAG_Update) != RESET)
+  {
+    TIM4_Cmd(ENABLE);
+    return FALSE;
+  }
+
+  /* Whole stretch counts that fit before the deadline, from the current tick phase */
+  if (u32Ticks > PORT_STRETCH_MAX_TICKS)
+  {
+    u32Ticks = PORT_STRETCH_MAX_TICKS;
+  }
+  u8StretchPhase = TIM4_GetCounter();
+  u32Units = (u32Ticks * PORT_TICK_UNITS) - u8StretchPhase;
+  u16StretchCounts = (uint16)(u32Units / PORT_STRETCH_UNITS);
+  if (u16StretchCounts > 256)
+  {
+    u16StretchCounts = 256;
+  }
+
+  /* Not worth it if the stretch does not go past the next tick */
+  if (((uint32)u16StretchCounts * PORT_STRETCH_UNITS) <= (PORT_TICK_UNITS - u8StretchPhase))
+  {
+    TIM4_Cmd(ENABLE);
+    return FALSE;
+  }
+
+  TIM4_TimeBaseInit(TIM4_Prescaler_32768, (uint8_t)(u16StretchCounts - 1));
+  TIM4_GenerateEvent(TIM4_EventSource_Update);
+  TIM4_ClearFlag(TIM4_FLAG_Update);
+  TIM4_Cmd(ENABLE);
+
+  return TRUE;
+}
+
+uint32 PORTABLE_u32TimebaseRestore(bool_t bTickReported)
+{
+  uint32 u32Units;
+  uint32 u32Ticks;
+  bool_t bPending;
+
+  TIM4_Cmd(DISABLE);
+  bPending = (TIM4_GetFlagStatus(TIM4_FLAG_Update) != RESET);
+
+  /* 8 us units since the start of the tick the stretch began in;
+     on an early wake-up the part of a count still in the prescaler is lost */
+  u32Units = u8StretchPhase + ((uint32)TIM4_GetCounter() * PORT_STRETCH_UNITS);
+  if (bTickReported || bPending)
+  {
+    u32Units += (uint32)u16StretchCounts * PORT_STRETCH_UNITS;
+  }
+  u32Ticks = u32Units / PORT_TICK_UNITS;
+
+  /* The interrupt ending the stretch counts as one of the ticks */
+  if (bPending)
+  {
+    TIM4_ClearFlag(TIM4_FLAG_Update);
+  }
+  else if (bTickReported)
+  {
+    u32Ticks--;
+  }
+
+  /* Back to the 1 ms period, in phase with the ticks before the stretch */
+  TIM4_TimeBaseInit(TIM4_Prescaler_128, PORT_TICK_UNITS - 1);
+  TIM4_GenerateEvent(TIM4_EventSource_Update);
+  TIM4_SetCounter((uint8_t)(u32Units % PORT_TICK_UNITS));
+  TIM4_ClearFlag(TIM4_FLAG_Update);
+  TIM4_Cmd(ENABLE);
+
+  return u32Ticks;
+}
+#endif
+
 /****************************************************************************/
 /***        Local Function                                                ***/
 /****************************************************************************/
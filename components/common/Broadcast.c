@@ -0,0 +1,226 @@
+/****************************************************************************
+ *
+ * MODULE:    Broadcast.c
+ *
+ * DESCRIPTION:
+ * Broadcast ring: one producer, up to BCAST_MAX_READERS readers that each keep
+ * their own cursor, so every item is stored once whatever the number of readers.
+ *
+ * Without overwrite a slot is reused only once the slowest reader has passed it.
+ * With overwrite the producer never waits; a reader that was lapped detects it on
+ * its next receive, skips to the oldest item still stored and counts the loss.
+ * In both modes the producer and each reader only write their own index, so they
+ * may run in different contexts (for instance an ISR) without a critical section.
+ * Readers must be added before the producer starts.
+ *
+ *
+ ****************************************************************************
+ *
+ * This software is owned by NXP B.V. and/or its supplier and is protected
+ * under applicable copyright laws. All rights are reserved. We grant You,
+ * and any third parties, a license to use this software solely and
+ * exclusively on NXP products [NXP Microcontrollers such as JN5168, JN5179].
+ * You, and any third parties must reproduce the copyright and warranty notice
+ * and any other legend of ownership on each copy or partial copy of the
+ * software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Copyright NXP B.V. 2016. All rights reserved
+ *
+ ***************************************************************************/
+
+
+/****************************************************************************/
+/***        Include files                                                 ***/
+/****************************************************************************/
+
+#include "chip_selection.h"
+#include "Broadcast.h"
+
+/****************************************************************************/
+/***        Macro Definitions                                             ***/
+/****************************************************************************/
+
+/* Largest power of two that still fits the 16 bit free running indices */
+#define BCAST_MAX_LENGTH        (0x8000UL)
+
+/****************************************************************************/
+/***        Type Definitions                                              ***/
+/****************************************************************************/
+
+/****************************************************************************/
+/***        Local Function Prototypes                                     ***/
+/****************************************************************************/
+
+/****************************************************************************/
+/***        Local Variables                                               ***/
+/****************************************************************************/
+
+/****************************************************************************/
+/***        Exported Functions                                            ***/
+/****************************************************************************/
+
+bool_t BCAST_bCreate ( tsBcast*       psBcast,
+                       const uint32   u32Length,
+                       const uint32   u32ItemSize,
+                       uint8*         pu8StartQueue,
+                       bool_t         bOverwrite )
+{
+    /* Index masking requires a power of two length */
+    if ((u32Length == 0) ||
+        (u32Length > BCAST_MAX_LENGTH) ||
+        ((u32Length & (u32Length - 1)) != 0))
+    {
+        return FALSE;
+    }
+
+    memset(psBcast, 0, sizeof(tsBcast));
+    psBcast->pvHead = pu8StartQueue;
+    psBcast->u32ItemSize = u32ItemSize;
+    psBcast->u16Mask = (uint16)(u32Length - 1);
+    psBcast->bOverwrite = bOverwrite;
+
+    return TRUE;
+}
+
+bool_t BCAST_bAddReader ( tsBcast*    psBcast,
+                          uint8*      pu8ReaderIndex )
+{
+    uint8 n;
+    tsBcastReader *psReader;
+
+    for (n = 0; n < BCAST_MAX_READERS; n++)
+    {
+        psReader = &psBcast->asReaders[n];
+
+        if (!psReader->bActive)
+        {
+            /* A new reader only sees items sent from now on */
+            psReader->u16ReadIndex = psBcast->u16WriteIndex;
+            psReader->u32Overruns = 0;
+            psReader->bActive = TRUE;
+
+            *pu8ReaderIndex = n;
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+void BCAST_vRemoveReader ( tsBcast*    psBcast,
+                           uint8       u8ReaderIndex )
+{
+    if (u8ReaderIndex < BCAST_MAX_READERS)
+    {
+        psBcast->asReaders[u8ReaderIndex].bActive = FALSE;
+    }
+}
+
+bool_t BCAST_bSend ( tsBcast*       psBcast,
+                     const void*    pvItemToQueue )
+{
+    uint16 u16Write = psBcast->u16WriteIndex;
+    uint8 n;
+
+    if (!psBcast->bOverwrite)
+    {
+        /* The slot is only free once the slowest reader has read it */
+        for (n = 0; n < BCAST_MAX_READERS; n++)
+        {
+            if (psBcast->asReaders[n].bActive &&
+                ((uint16)(u16Write - psBcast->asReaders[n].u16ReadIndex) > psBcast->u16Mask))
+            {
+                psBcast->u32SendFail++;
+                return FALSE;
+            }
+        }
+    }
+
+    ( void ) memcpy( psBcast->pvHead + ((uint32)(u16Write & psBcast->u16Mask) * psBcast->u32ItemSize),
+                     pvItemToQueue, psBcast->u32ItemSize );
+
+    /* The item must be visible before the readers can see the new index */
+    QUEUE_MEMORY_BARRIER();
+    psBcast->u16WriteIndex = (uint16)(u16Write + 1);
+
+    return TRUE;
+}
+
+bool_t BCAST_bReceive ( tsBcast*    psBcast,
+                        uint8       u8ReaderIndex,
+                        void*       pvItemFromQueue )
+{
+    tsBcastReader *psReader = &psBcast->asReaders[u8ReaderIndex];
+    uint16 u16Read = psReader->u16ReadIndex;
+    uint16 u16Write;
+
+    while (1)
+    {
+        u16Write = psBcast->u16WriteIndex;
+
+        if (u16Read == u16Write)
+        {
+            psReader->u16ReadIndex = u16Read;
+            return FALSE;
+        }
+
+        /* When the ring is full the producer may already be rewriting the oldest
+         * slot, so a lapped reader restarts on the oldest slot that is stable */
+        if (psBcast->bOverwrite &&
+            ((uint16)(u16Write - u16Read) > psBcast->u16Mask))
+        {
+            psReader->u32Overruns += (uint16)(u16Write - u16Read) - psBcast->u16Mask;
+            u16Read = (uint16)(u16Write - psBcast->u16Mask);
+        }
+
+        /* Do not read the item before the write index that published it */
+        QUEUE_MEMORY_BARRIER();
+        ( void ) memcpy( pvItemFromQueue,
+                         psBcast->pvHead + ((uint32)(u16Read & psBcast->u16Mask) * psBcast->u32ItemSize),
+                         psBcast->u32ItemSize );
+        QUEUE_MEMORY_BARRIER();
+
+        /* Only an overwriting producer can have reused the slot during the copy */
+        if (!psBcast->bOverwrite ||
+            ((uint16)(psBcast->u16WriteIndex - u16Read) <= psBcast->u16Mask))
+        {
+            break;
+        }
+    }
+
+    psReader->u16ReadIndex = (uint16)(u16Read + 1);
+
+    return TRUE;
+}
+
+uint32 BCAST_u32GetLag ( tsBcast*    psBcast,
+                         uint8       u8ReaderIndex )
+{
+    return (uint16)(psBcast->u16WriteIndex - psBcast->asReaders[u8ReaderIndex].u16ReadIndex);
+}
+
+uint32 BCAST_u32GetOverruns ( tsBcast*    psBcast,
+                              uint8       u8ReaderIndex )
+{
+    return psBcast->asReaders[u8ReaderIndex].u32Overruns;
+}
+
+/****************************************************************************/
+/***        Local Functions                                               ***/
+/****************************************************************************/
+
+/****************************************************************************/
+/***        END OF FILE                                                   ***/
+/****************************************************************************/
@@ -0,0 +1,88 @@
+/****************************************************************************
+ *
+ * MODULE: Broadcast.h
+ *
+ * DESCRIPTION:
+ * Broadcast ring with independent reader cursors
+ *
+ *
+ ****************************************************************************
+ *
+ * This software is owned by NXP B.V. and/or its supplier and is protected
+ * under applicable copyright laws. All rights are reserved. We grant You,
+ * and any third parties, a license to use this software solely and
+ * exclusively on NXP products [NXP Microcontrollers such as JN5168, JN5179].
+ * You, and any third parties must reproduce the copyright and warranty notice
+ * and any other legend of ownership on each copy or partial copy of the
+ * software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Copyright NXP B.V. 2016. All rights reserved
+ *
+ ***************************************************************************/
+
+
+#ifndef BROADCAST_H_
+#define BROADCAST_H_
+
+#include "chip_selection.h"
+#include "Queue.h"
+
+/****************************************************************************/
+/***        Macro Definitions                                             ***/
+/****************************************************************************/
+
+#ifndef BCAST_MAX_READERS
+#define BCAST_MAX_READERS       (4)
+#endif
+
+/****************************************************************************/
+/***        Type Definitions                                              ***/
+/****************************************************************************/
+
+typedef struct
+{
+    volatile uint16 u16ReadIndex;      /*< Free running index of the next item, modified by this reader only. */
+    bool_t bActive;
+    uint32 u32Overruns;                /*< Items this reader lost because the producer lapped it. */
+}tsBcastReader;
+
+typedef struct
+{
+    volatile uint16 u16WriteIndex;     /*< Free running write index, modified by the producer only. */
+    uint16 u16Mask;                    /*< Length - 1, the length must be a power of two. */
+    uint32 u32ItemSize;                /*< The size of each items that the ring will hold. */
+    uint8  *pvHead;                    /*< Points to the beginning of the storage area. */
+    bool_t bOverwrite;                 /*< TRUE: a full ring laps slow readers, FALSE: the send fails. */
+    uint32 u32SendFail;                /*< Sends refused because the slowest reader had not caught up. */
+    tsBcastReader asReaders[BCAST_MAX_READERS];
+}tsBcast;
+
+/****************************************************************************/
+/***        Exported Functions                                            ***/
+/****************************************************************************/
+
+bool_t BCAST_bCreate(tsBcast *psBcast, const uint32 u32Length, const uint32 u32ItemSize, uint8 *pu8StartQueue, bool_t bOverwrite);
+bool_t BCAST_bAddReader(tsBcast *psBcast, uint8 *pu8ReaderIndex);
+void BCAST_vRemoveReader(tsBcast *psBcast, uint8 u8ReaderIndex);
+bool_t BCAST_bSend(tsBcast *psBcast, const void *pvItemToQueue);
+bool_t BCAST_bReceive(tsBcast *psBcast, uint8 u8ReaderIndex, void *pvItemFromQueue);
+uint32 BCAST_u32GetLag(tsBcast *psBcast, uint8 u8ReaderIndex);
+uint32 BCAST_u32GetOverruns(tsBcast *psBcast, uint8 u8ReaderIndex);
+
+#endif /*BROADCAST_H_*/
+
+/****************************************************************************/
+/***        END OF FILE                                                   ***/
+/****************************************************************************/
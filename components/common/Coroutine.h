@@ -0,0 +1,127 @@
+/****************************************************************************
+ *
+ * MODULE: Coroutine.h
+ *
+ * DESCRIPTION:
+ * Stackless coroutines for waits that would otherwise spin
+ *
+ * A coroutine is a function taking a CO_tsState and returning CO_teStatus,
+ * with its body between CO_BEGIN and CO_END. CO_WAIT_UNTIL and CO_YIELD
+ * return to the caller, which calls the function again later to resume it
+ * after the wait; the state is the resume point only, two bytes. The usual
+ * protothread limits apply: local variables are not kept across a wait (keep
+ * them in static storage or behind a parameter), a wait may not sit inside a
+ * switch statement of the body, and only one wait per source line.
+ *
+ * Code that has to block, like the FatFs disk functions, runs a coroutine to
+ * its end with CO_BLOCK; every time the coroutine waits, CO_vIdle calls the
+ * hook set with CO_vSetIdle, typically SCHED_vYield.
+ *
+ *
+ ****************************************************************************
+ *
+ * This software is owned by NXP B.V. and/or its supplier and is protected
+ * under applicable copyright laws. All rights are reserved. We grant You,
+ * and any third parties, a license to use this software solely and
+ * exclusively on NXP products [NXP Microcontrollers such as JN5168, JN5179].
+ * You, and any third parties must reproduce the copyright and warranty notice
+ * and any other legend of ownership on each copy or partial copy of the
+ * software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Copyright NXP B.V. 2016. All rights reserved
+ *
+ ***************************************************************************/
+
+#ifndef COROUTINE_H_
+#define COROUTINE_H_
+
+#include "chip_selection.h"
+
+/****************************************************************************/
+/***        Macro Definitions                                             ***/
+/****************************************************************************/
+
+#define CO_INIT(psCo)               ((psCo)->u16Resume = 0)
+
+#define CO_BEGIN(psCo)              switch ((psCo)->u16Resume) { case 0:
+
+#define CO_END(psCo)                } (psCo)->u16Resume = 0; return E_CO_DONE
+
+/* Returns E_CO_WAITING until cCondition holds; cCondition is evaluated again
+ * on every resume */
+#define CO_WAIT_UNTIL(psCo, cCondition)                                     \
+        do {                                                                \
+            (psCo)->u16Resume = __LINE__; case __LINE__:                    \
+            if (!(cCondition)) return E_CO_WAITING;                         \
+        } while (0)
+
+#define CO_WAIT_WHILE(psCo, cCondition)  CO_WAIT_UNTIL((psCo), !(cCondition))
+
+/* Returns E_CO_YIELDED once and goes on from here on the next resume */
+#define CO_YIELD(psCo)                                                      \
+        do {                                                                \
+            (psCo)->u16Resume = __LINE__; return E_CO_YIELDED; case __LINE__:; \
+        } while (0)
+
+/* Runs the child coroutine psChild, started by cCall, to its end */
+#define CO_WAIT_CHILD(psCo, psChild, cCall)                                 \
+        do {                                                                \
+            CO_INIT(psChild);                                               \
+            CO_WAIT_UNTIL((psCo), (cCall) == E_CO_DONE);                    \
+        } while (0)
+
+#define CO_EXIT(psCo)               do { (psCo)->u16Resume = 0; return E_CO_DONE; } while (0)
+
+/* Runs the coroutine started by cCall to its end, idling while it waits.
+ * Not for use from an ISR. */
+#define CO_BLOCK(psCo, cCall)                                               \
+        do {                                                                \
+            CO_INIT(psCo);                                                  \
+            while ((cCall) != E_CO_DONE)                                    \
+            {                                                               \
+                CO_vIdle();                                                 \
+            }                                                               \
+        } while (0)
+
+/****************************************************************************/
+/***        Type Definitions                                              ***/
+/****************************************************************************/
+
+typedef struct
+{
+    uint16 u16Resume;                  /*< Source line to resume at, 0 before the start. */
+}CO_tsState;
+
+typedef enum
+{
+    E_CO_WAITING,
+    E_CO_YIELDED,
+    E_CO_DONE
+}CO_teStatus;
+
+typedef void (*CO_tpfIdle)(void);
+
+/****************************************************************************/
+/***        Exported Functions                                            ***/
+/****************************************************************************/
+
+void CO_vSetIdle(CO_tpfIdle pfIdle);
+void CO_vIdle(void);
+
+#endif /*COROUTINE_H_*/
+
+/****************************************************************************/
+/***        END OF FILE                                                   ***/
+/****************************************************************************/
@@ -0,0 +1,264 @@
+/****************************************************************************
+ *
+ * MODULE:    Defer.c
+ *
+ * DESCRIPTION:
+ * Deferred interrupt work: a handler only takes what the hardware has for it,
+ * posts a work item (function, context and a 16 bit datum) with DEFER_bPost
+ * and returns; the main context runs the item later, through DEFER_vRun, the
+ * scheduler (SCHED_bAddDeferTask) or a queue set (QSET_vAddDefer). Handlers
+ * stay short however much the work costs, so that a burst on one peripheral
+ * does not overrun another.
+ *
+ * Each interrupt priority posts to its own ring, a tsQueueSpsc written by the
+ * handlers of that priority only and read by the main context, so neither side
+ * disables interrupts. The rings are run in level order: an item of level 0
+ * runs before any item of level 1 that is waiting.
+ *
+ ****************************************************************************
+ *
+ * This software is owned by NXP B.V. and/or its supplier and is protected
+ * under applicable copyright laws. All rights are reserved. We grant You,
+ * and any third parties, a license to use this software solely and
+ * exclusively on NXP products [NXP Microcontrollers such as JN5168, JN5179].
+ * You, and any third parties must reproduce the copyright and warranty notice
+ * and any other legend of ownership on each copy or partial copy of the
+ * software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Copyright NXP B.V. 2016. All rights reserved
+ *
+ ***************************************************************************/
+
+/****************************************************************************/
+/***        Include files                                                 ***/
+/****************************************************************************/
+
+#include "chip_selection.h"
+#include "Defer.h"
+#include "Queue.h"
+#ifdef DEFER_SUPPORT_STATISTICS
+#include <string.h>
+#include "dbg.h"
+#endif
+
+/****************************************************************************/
+/***        Macro Definitions                                             ***/
+/****************************************************************************/
+
+#if ((DEFER_RING_LENGTH & (DEFER_RING_LENGTH - 1)) != 0)
+#error "DEFER_RING_LENGTH must be a power of two"
+#endif
+
+/****************************************************************************/
+/***        Type Definitions                                              ***/
+/****************************************************************************/
+
+typedef struct
+{
+    tsQueueSpsc     asRings[DEFER_NUM_LEVELS];
+    DEFER_tsWork    aasWork[DEFER_NUM_LEVELS][DEFER_RING_LENGTH];
+#ifdef DEFER_SUPPORT_STATISTICS
+    DEFER_tsStatistics asStatistics[DEFER_NUM_LEVELS];
+#endif
+}DEFER_tsCommon;
+
+/****************************************************************************/
+/***        Local Function Prototypes                                     ***/
+/****************************************************************************/
+
+/****************************************************************************/
+/***        Local Variables                                               ***/
+/****************************************************************************/
+
+static DEFER_tsCommon DEFER_sCommon;
+
+/****************************************************************************/
+/***        Exported Functions                                            ***/
+/****************************************************************************/
+
+/* Must be called before any interrupt that posts work is enabled */
+void DEFER_vInit ( void )
+{
+    uint8 n;
+
+    for (n = 0; n < DEFER_NUM_LEVELS; n++)
+    {
+        (void)QUEUE_bSpscCreate(&DEFER_sCommon.asRings[n], DEFER_RING_LENGTH,
+                                sizeof(DEFER_tsWork), (uint8 *)DEFER_sCommon.aasWork[n]);
+    }
+#ifdef DEFER_SUPPORT_STATISTICS
+    memset(DEFER_sCommon.asStatistics, 0, sizeof(DEFER_sCommon.asStatistics));
+#endif
+}
+
+/* Called by the handlers of interrupt level u8Level only. Returns FALSE when
+ * the ring is full, the work is then lost. */
+bool_t DEFER_bPost ( uint8            u8Level,
+                     DEFER_tpfWork    pfWork,
+                     void*            pvParam,
+                     uint16           u16Data )
+{
+    DEFER_tsWork sWork;
+    bool_t bPosted;
+
+    if (u8Level >= DEFER_NUM_LEVELS)
+    {
+        return FALSE;
+    }
+
+    sWork.pfWork = pfWork;
+    sWork.pvParam = pvParam;
+    sWork.u16Data = u16Data;
+#ifdef DEFER_SUPPORT_STATISTICS
+    sWork.u32Posted = TIMER_u32NowUs();
+#endif
+
+    bPosted = QUEUE_bSpscSend(&DEFER_sCommon.asRings[u8Level], &sWork);
+
+#ifdef DEFER_SUPPORT_STATISTICS
+    {
+        DEFER_tsStatistics *psStatistics = &DEFER_sCommon.asStatistics[u8Level];
+        uint16 u16Waiting;
+
+        if (bPosted)
+        {
+            psStatistics->u32Posted++;
+            u16Waiting = (uint16)QUEUE_u32SpscGetMessageWaiting(&DEFER_sCommon.asRings[u8Level]);
+            if (u16Waiting > psStatistics->u16HighWater)
+            {
+                psStatistics->u16HighWater = u16Waiting;
+            }
+        }
+        else
+        {
+            psStatistics->u32Dropped++;
+        }
+    }
+#endif
+
+    return bPosted;
+}
+
+bool_t DEFER_bIsPending ( void )
+{
+    uint8 n;
+
+    for (n = 0; n < DEFER_NUM_LEVELS; n++)
+    {
+        if (!QUEUE_bSpscIsEmpty(&DEFER_sCommon.asRings[n]))
+        {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/* Runs the oldest work item of the lowest level that has one, returns FALSE
+ * when there was none */
+bool_t DEFER_bRunOne ( void )
+{
+    DEFER_tsWork sWork;
+    uint8 n;
+
+    for (n = 0; n < DEFER_NUM_LEVELS; n++)
+    {
+        if (QUEUE_bSpscReceive(&DEFER_sCommon.asRings[n], &sWork))
+        {
+#ifdef DEFER_SUPPORT_STATISTICS
+            uint32 u32Latency = TIMER_u32NowUs() - sWork.u32Posted;
+
+            if (u32Latency > DEFER_sCommon.asStatistics[n].u32MaxLatency)
+            {
+                DEFER_sCommon.asStatistics[n].u32MaxLatency = u32Latency;
+            }
+#endif
+            sWork.pfWork(sWork.pvParam, sWork.u16Data);
+
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/* Runs work until none is left, including work posted meanwhile */
+void DEFER_vRun ( void )
+{
+    while (DEFER_bRunOne())
+    {
+    }
+}
+
+#ifdef DEFER_SUPPORT_STATISTICS
+/* DEFER_ISR_EXIT: end of a handler of level u8Level started at u32Start */
+void DEFER_vIsrExit ( uint8     u8Level,
+                      uint32    u32Start )
+{
+    uint32 u32Duration = DEFER_ISR_STAMP() - u32Start;
+
+    if ((u8Level < DEFER_NUM_LEVELS) &&
+        (u32Duration > DEFER_sCommon.asStatistics[u8Level].u32MaxIsr))
+    {
+        DEFER_sCommon.asStatistics[u8Level].u32MaxIsr = u32Duration;
+    }
+}
+
+void DEFER_vGetStatistics ( uint8                  u8Level,
+                            DEFER_tsStatistics*    psStatistics )
+{
+    uint8 u8State = PORTABLE_u8EnterCritical();
+
+    *psStatistics = DEFER_sCommon.asStatistics[u8Level];
+
+    PORTABLE_vExitCritical(u8State);
+}
+
+void DEFER_vResetStatistics ( void )
+{
+    uint8 u8State = PORTABLE_u8EnterCritical();
+
+    memset(DEFER_sCommon.asStatistics, 0, sizeof(DEFER_sCommon.asStatistics));
+
+    PORTABLE_vExitCritical(u8State);
+}
+
+void DEFER_vDumpStatistics ( void )
+{
+    DEFER_tsStatistics sStatistics;
+    uint8 n;
+
+    for (n = 0; n < DEFER_NUM_LEVELS; n++)
+    {
+        DEFER_vGetStatistics(n, &sStatistics);
+        DBG_vPrintf(TRUE, "DEFER: Level=%u Posted=%lu Dropped=%lu HighWater=%u MaxLatency=%luus MaxIsr=%lu%s\n",
+                    n,
+                    (unsigned long)sStatistics.u32Posted,
+                    (unsigned long)sStatistics.u32Dropped,
+                    sStatistics.u16HighWater,
+                    (unsigned long)sStatistics.u32MaxLatency,
+                    (unsigned long)sStatistics.u32MaxIsr,
+                    DEFER_ISR_UNIT);
+    }
+}
+#endif
+
+/****************************************************************************/
+/***        Local Functions                                               ***/
+/****************************************************************************/
+
+/****************************************************************************/
+/***        END OF FILE                                                   ***/
+/****************************************************************************/
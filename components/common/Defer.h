@@ -0,0 +1,133 @@
+/****************************************************************************
+ *
+ * MODULE: Defer.h
+ *
+ * DESCRIPTION:
+ * Work deferred from interrupt handlers to the main context
+ *
+ *
+ ****************************************************************************
+ *
+ * This software is owned by NXP B.V. and/or its supplier and is protected
+ * under applicable copyright laws. All rights are reserved. We grant You,
+ * and any third parties, a license to use this software solely and
+ * exclusively on NXP products [NXP Microcontrollers such as JN5168, JN5179].
+ * You, and any third parties must reproduce the copyright and warranty notice
+ * and any other legend of ownership on each copy or partial copy of the
+ * software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Copyright NXP B.V. 2016. All rights reserved
+ *
+ ***************************************************************************/
+
+#ifndef DEFER_H_
+#define DEFER_H_
+
+#include "chip_selection.h"
+#ifdef DEFER_SUPPORT_STATISTICS
+#include "port_mcu.h"
+#include "Timer.h"
+#endif
+
+/****************************************************************************/
+/***        Macro Definitions                                             ***/
+/****************************************************************************/
+
+/* One ring per interrupt priority that posts work, level 0 is run first.
+ * Interrupts that may preempt each other must post to different levels,
+ * each ring takes a single producer. */
+#ifndef DEFER_NUM_LEVELS
+#define DEFER_NUM_LEVELS        (1)
+#endif
+
+/* Work items per ring, a power of two */
+#ifndef DEFER_RING_LENGTH
+#define DEFER_RING_LENGTH       (8)
+#endif
+
+/* Define DEFER_SUPPORT_STATISTICS to count the work posted and dropped on each
+ * level and keep the longest wait of a work item (us) and the longest handler
+ * bracketed by DEFER_ISR_ENTER / DEFER_ISR_EXIT (core cycles where the port has
+ * a cycle counter, us otherwise). DEFER_ISR_ENTER declares a variable, it comes
+ * first in the handler. */
+#ifdef DEFER_SUPPORT_STATISTICS
+#ifdef PORTABLE_SUPPORT_CYCLE_COUNTER
+#define DEFER_ISR_STAMP()       PORTABLE_u32CycleCounter()
+#define DEFER_ISR_UNIT          "cycles"
+#else
+#define DEFER_ISR_STAMP()       TIMER_u32NowUs()
+#define DEFER_ISR_UNIT          "us"
+#endif
+#define DEFER_ISR_ENTER()       uint32 u32DeferIsrStart = DEFER_ISR_STAMP()
+#define DEFER_ISR_EXIT(u8Level) DEFER_vIsrExit((u8Level), u32DeferIsrStart)
+#else
+#define DEFER_ISR_ENTER()
+#define DEFER_ISR_EXIT(u8Level)
+#endif
+
+/****************************************************************************/
+/***        Type Definitions                                              ***/
+/****************************************************************************/
+
+/* u16Data carries what the handler read from the hardware, a received byte or
+ * a status word, so that pvParam can stay a fixed context */
+typedef void (*DEFER_tpfWork)(void *pvParam, uint16 u16Data);
+
+typedef struct
+{
+    DEFER_tpfWork   pfWork;
+    void            *pvParam;
+    uint16          u16Data;
+#ifdef DEFER_SUPPORT_STATISTICS
+    uint32          u32Posted;          /*< TIMER_u32NowUs when posted. */
+#endif
+} DEFER_tsWork;
+
+#ifdef DEFER_SUPPORT_STATISTICS
+typedef struct
+{
+    uint32  u32Posted;                  /*< Work items accepted. */
+    uint32  u32Dropped;                 /*< Work items refused, the ring was full. */
+    uint32  u32MaxLatency;              /*< Longest time from post to run, us. */
+    uint32  u32MaxIsr;                  /*< Longest handler, DEFER_ISR_UNIT. */
+    uint16  u16HighWater;               /*< Most work items ever waiting. */
+} DEFER_tsStatistics;
+#endif
+
+/****************************************************************************/
+/***        Exported Functions                                            ***/
+/****************************************************************************/
+
+void DEFER_vInit(void);
+bool_t DEFER_bPost(uint8 u8Level, DEFER_tpfWork pfWork, void *pvParam, uint16 u16Data);
+bool_t DEFER_bIsPending(void);
+bool_t DEFER_bRunOne(void);
+void DEFER_vRun(void);
+#ifdef DEFER_SUPPORT_STATISTICS
+void DEFER_vIsrExit(uint8 u8Level, uint32 u32Start);
+void DEFER_vGetStatistics(uint8 u8Level, DEFER_tsStatistics *psStatistics);
+void DEFER_vResetStatistics(void);
+void DEFER_vDumpStatistics(void);
+#endif
+
+/****************************************************************************/
+/***        External Variables                                            ***/
+/****************************************************************************/
+
+/****************************************************************************/
+/****************************************************************************/
+/****************************************************************************/
+
+#endif /*DEFER_H_*/
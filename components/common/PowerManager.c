@@ -0,0 +1,270 @@
+/****************************************************************************
+ *
+ * MODULE:    PowerManager.c
+ *
+ * DESCRIPTION:
+ * Power manager: timers, queues and drivers count their activity, and the idle
+ * loops of QSET_u8Wait and SCHED_vRun ask PWRM_vIdle for the deepest mode that
+ * none of the activities in progress forbids. A running timer opened with
+ * TIMER_FLAG_PREVENT_SLEEP, a queue holding items or a driver transfer keeps
+ * the core in SLEEP, where the tick and the peripheral clocks run; a wake-up
+ * source on the low speed clock allows STOP but not STANDBY. With no activity
+ * the mode set by PWRM_vSetDeepestMode is used, if the idle loop allows deep
+ * sleep at all. Timers that do not prevent sleep stand still in STOP and
+ * STANDBY, as the tick timer does.
+ *
+ * Activities may start and finish in an ISR; the counts are changed in a
+ * critical section. Define PWRM_SUPPORT_STATISTICS to count the entries of
+ * every mode and the time spent in RUN and SLEEP.
+ *
+ ****************************************************************************
+ *
+ * This software is owned by NXP B.V. and/or its supplier and is protected
+ * under applicable copyright laws. All rights are reserved. We grant You,
+ * and any third parties, a license to use this software solely and
+ * exclusively on NXP products [NXP Microcontrollers such as JN5168, JN5179].
+ * You, and any third parties must reproduce the copyright and warranty notice
+ * and any other legend of ownership on each copy or partial copy of the
+ * software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Copyright NXP B.V. 2016. All rights reserved
+ *
+ ***************************************************************************/
+
+/****************************************************************************/
+/***        Include files                                                 ***/
+/****************************************************************************/
+
+#include "chip_selection.h"
+#include "PowerManager.h"
+#include "Timer.h"
+#ifdef PWRM_SUPPORT_STATISTICS
+#include <string.h>
+#include "dbg.h"
+#endif
+
+/****************************************************************************/
+/***        Macro Definitions                                             ***/
+/****************************************************************************/
+
+/****************************************************************************/
+/***        Type Definitions                                              ***/
+/****************************************************************************/
+
+typedef struct
+{
+    volatile uint16 au16Count[E_PWRM_NUM_ACTIVITIES];
+#ifdef PWRM_SUPPORT_STATISTICS
+    PWRM_tsResidency asResidency[E_PWRM_NUM_MODES];
+    uint32          u32LastUs;          /*< TIMER_u32NowUs when the mode last changed. */
+#endif
+}PWRM_tsCommon;
+
+/****************************************************************************/
+/***        Local Function Prototypes                                     ***/
+/****************************************************************************/
+
+#ifdef PWRM_SUPPORT_STATISTICS
+static void PWRM_vAccount(PWRM_teMode eMode, bool_t bTimed);
+#endif
+
+/****************************************************************************/
+/***        Local Variables                                               ***/
+/****************************************************************************/
+
+/* Deepest mode each source still allows while it is active */
+static const uint8 PWRM_au8Limit[E_PWRM_NUM_ACTIVITIES] =
+{
+    E_PWRM_MODE_SLEEP,                  /* E_PWRM_ACTIVITY_TIMER */
+    E_PWRM_MODE_SLEEP,                  /* E_PWRM_ACTIVITY_QUEUE */
+    E_PWRM_MODE_SLEEP,                  /* E_PWRM_ACTIVITY_DRIVER */
+    E_PWRM_MODE_STOP                    /* E_PWRM_ACTIVITY_LOW_SPEED */
+};
+
+static PWRM_tsCommon PWRM_sCommon;
+static PWRM_teMode PWRM_eDeepest = PWRM_DEEPEST_MODE;
+
+/****************************************************************************/
+/***        Exported Functions                                            ***/
+/****************************************************************************/
+
+void PWRM_vStartActivity ( PWRM_teActivity    eActivity )
+{
+    uint8 u8State = PORTABLE_u8EnterCritical();
+
+    PWRM_sCommon.au16Count[eActivity]++;
+
+    PORTABLE_vExitCritical(u8State);
+}
+
+/* A finish without a matching start is ignored */
+void PWRM_vFinishActivity ( PWRM_teActivity    eActivity )
+{
+    uint8 u8State = PORTABLE_u8EnterCritical();
+
+    if (PWRM_sCommon.au16Count[eActivity] > 0)
+    {
+        PWRM_sCommon.au16Count[eActivity]--;
+    }
+
+    PORTABLE_vExitCritical(u8State);
+}
+
+uint16 PWRM_u16GetActivityCount ( PWRM_teActivity    eActivity )
+{
+    return PWRM_sCommon.au16Count[eActivity];
+}
+
+void PWRM_vSetDeepestMode ( PWRM_teMode    eMode )
+{
+    if (eMode < E_PWRM_MODE_SLEEP)
+    {
+        eMode = E_PWRM_MODE_SLEEP;
+    }
+    else if (eMode > E_PWRM_MODE_STANDBY)
+    {
+        eMode = E_PWRM_MODE_STANDBY;
+    }
+
+    PWRM_eDeepest = eMode;
+}
+
+/* The mode PWRM_vIdle would enter now: SLEEP unless bDeepSleep, else the
+ * deepest mode set, limited by every source with activity in progress */
+PWRM_teMode PWRM_eSelectMode ( bool_t    bDeepSleep )
+{
+    uint8 u8Mode = E_PWRM_MODE_SLEEP;
+    uint8 n;
+
+    if (bDeepSleep)
+    {
+        u8Mode = (uint8)PWRM_eDeepest;
+
+        for (n = 0; n < E_PWRM_NUM_ACTIVITIES; n++)
+        {
+            if ((PWRM_sCommon.au16Count[n] != 0) && (u8Mode > PWRM_au8Limit[n]))
+            {
+                u8Mode = PWRM_au8Limit[n];
+            }
+        }
+    }
+
+    return (PWRM_teMode)u8Mode;
+}
+
+/* Sleeps once in the selected mode. Called and returns with interrupts
+ * disabled, after the waking ISR has run. bTimer: the caller serves the timer
+ * tick, which may then sleep until the next timer deadline (tickless builds). */
+void PWRM_vIdle ( bool_t    bTimer,
+                  bool_t    bDeepSleep )
+{
+    PWRM_teMode eMode = PWRM_eSelectMode(bDeepSleep);
+
+    /* Only SLEEP keeps the tick timer running */
+    bTimer = (bool_t)(bTimer && (eMode == E_PWRM_MODE_SLEEP));
+
+#ifdef PWRM_SUPPORT_STATISTICS
+    PWRM_vAccount(E_PWRM_MODE_RUN, TRUE);
+#endif
+    if (bTimer)
+    {
+        TIMER_vSleep();
+    }
+
+    /* Returns with interrupts enabled */
+    PORTABLE_vIdle((uint8)eMode);
+
+    PORTABLE_vDisableInterrupts();
+    if (bTimer)
+    {
+        TIMER_vWake();
+    }
+#ifdef PWRM_SUPPORT_STATISTICS
+    PWRM_vAccount(eMode, (bool_t)(eMode == E_PWRM_MODE_SLEEP));
+#endif
+}
+
+#ifdef PWRM_SUPPORT_STATISTICS
+void PWRM_vGetResidency ( PWRM_teMode          eMode,
+                          PWRM_tsResidency*    psResidency )
+{
+    uint8 u8State = PORTABLE_u8EnterCritical();
+
+    *psResidency = PWRM_sCommon.asResidency[eMode];
+
+    PORTABLE_vExitCritical(u8State);
+}
+
+void PWRM_vResetResidency ( void )
+{
+    uint8 u8State = PORTABLE_u8EnterCritical();
+
+    memset(PWRM_sCommon.asResidency, 0, sizeof(PWRM_sCommon.asResidency));
+    PWRM_sCommon.u32LastUs = TIMER_u32NowUs();
+
+    PORTABLE_vExitCritical(u8State);
+}
+
+void PWRM_vDumpResidency ( void )
+{
+    static const char *const apcNames[E_PWRM_NUM_MODES] = { "RUN", "SLEEP", "STOP", "STANDBY" };
+    PWRM_tsResidency sResidency;
+    uint8 n;
+
+    for (n = 0; n < E_PWRM_NUM_MODES; n++)
+    {
+        PWRM_vGetResidency((PWRM_teMode)n, &sResidency);
+        DBG_vPrintf(TRUE, "PWRM: %s Entries=%lu Time=%lu.%03ums\n",
+                    apcNames[n],
+                    (unsigned long)sResidency.u32Entries,
+                    (unsigned long)sResidency.u32Ms,
+                    sResidency.u16Us);
+    }
+    DBG_vPrintf(TRUE, "PWRM: Activity Timer=%u Queue=%u Driver=%u LowSpeed=%u\n",
+                PWRM_sCommon.au16Count[E_PWRM_ACTIVITY_TIMER],
+                PWRM_sCommon.au16Count[E_PWRM_ACTIVITY_QUEUE],
+                PWRM_sCommon.au16Count[E_PWRM_ACTIVITY_DRIVER],
+                PWRM_sCommon.au16Count[E_PWRM_ACTIVITY_LOW_SPEED]);
+}
+#endif
+
+/****************************************************************************/
+/***        Local Functions                                               ***/
+/****************************************************************************/
+
+#ifdef PWRM_SUPPORT_STATISTICS
+/* Ends a period spent in eMode, with interrupts disabled. The time is only
+ * added when the tick ran through it (bTimed). */
+static void PWRM_vAccount ( PWRM_teMode    eMode,
+                            bool_t         bTimed )
+{
+    PWRM_tsResidency *psResidency = &PWRM_sCommon.asResidency[eMode];
+    uint32 u32Now = TIMER_u32NowUs();
+    uint32 u32Us;
+
+    psResidency->u32Entries++;
+    if (bTimed)
+    {
+        u32Us = (u32Now - PWRM_sCommon.u32LastUs) + psResidency->u16Us;
+        psResidency->u32Ms += u32Us / 1000;
+        psResidency->u16Us = (uint16)(u32Us % 1000);
+    }
+    PWRM_sCommon.u32LastUs = u32Now;
+}
+#endif
+
+/****************************************************************************/
+/***        END OF FILE                                                   ***/
+/****************************************************************************/
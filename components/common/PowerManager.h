@@ -0,0 +1,121 @@
+/****************************************************************************
+ *
+ * MODULE: PowerManager.h
+ *
+ * DESCRIPTION:
+ * Activity counting and selection of the idle mode
+ *
+ *
+ ****************************************************************************
+ *
+ * This software is owned by NXP B.V. and/or its supplier and is protected
+ * under applicable copyright laws. All rights are reserved. We grant You,
+ * and any third parties, a license to use this software solely and
+ * exclusively on NXP products [NXP Microcontrollers such as JN5168, JN5179].
+ * You, and any third parties must reproduce the copyright and warranty notice
+ * and any other legend of ownership on each copy or partial copy of the
+ * software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Copyright NXP B.V. 2016. All rights reserved
+ *
+ ***************************************************************************/
+
+#ifndef POWERMANAGER_H_
+#define POWERMANAGER_H_
+
+#include "chip_selection.h"
+#include "port_mcu.h"
+
+/****************************************************************************/
+/***        Macro Definitions                                             ***/
+/****************************************************************************/
+
+/* Deepest mode entered when the idle loop allows deep sleep, until changed by
+ * PWRM_vSetDeepestMode. E_PWRM_MODE_STANDBY loses the RAM on Cortex-M and
+ * only ends through a reset, so it has to be asked for. */
+#ifndef PWRM_DEEPEST_MODE
+#define PWRM_DEEPEST_MODE       E_PWRM_MODE_STOP
+#endif
+
+/****************************************************************************/
+/***        Type Definitions                                              ***/
+/****************************************************************************/
+
+/* Idle modes, lightest first:
+ *                  Cortex-M        STM8L           STM8S
+ *  SLEEP           Sleep           Wait            Wait
+ *  STOP            Stop            Active-Halt     Halt
+ *  STANDBY         Standby         Halt            Halt
+ * Only SLEEP keeps the tick timer and the peripheral clocks running. */
+typedef enum
+{
+    E_PWRM_MODE_RUN,
+    E_PWRM_MODE_SLEEP = PORTABLE_IDLE_SLEEP,
+    E_PWRM_MODE_STOP = PORTABLE_IDLE_STOP,
+    E_PWRM_MODE_STANDBY = PORTABLE_IDLE_STANDBY,
+    E_PWRM_NUM_MODES
+} PWRM_teMode;
+
+/* Sources of activity. While the count of a source is not 0 the idle mode is
+ * no deeper than:
+ *  TIMER       SLEEP, running timers opened with TIMER_FLAG_PREVENT_SLEEP
+ *  QUEUE       SLEEP, queues holding items
+ *  DRIVER      SLEEP, transfers in progress that need the peripheral clock
+ *  LOW_SPEED   STOP, wake-up sources on the low speed clock (RTC, AWU) */
+typedef enum
+{
+    E_PWRM_ACTIVITY_TIMER,
+    E_PWRM_ACTIVITY_QUEUE,
+    E_PWRM_ACTIVITY_DRIVER,
+    E_PWRM_ACTIVITY_LOW_SPEED,
+    E_PWRM_NUM_ACTIVITIES
+} PWRM_teActivity;
+
+#ifdef PWRM_SUPPORT_STATISTICS
+/* Time spent in a mode since PWRM_vResetResidency. The tick timer stops in STOP
+ * and STANDBY, so for them only the entries are counted. */
+typedef struct
+{
+    uint32  u32Entries;
+    uint32  u32Ms;
+    uint16  u16Us;
+} PWRM_tsResidency;
+#endif
+
+/****************************************************************************/
+/***        Exported Functions                                            ***/
+/****************************************************************************/
+
+void PWRM_vStartActivity(PWRM_teActivity eActivity);
+void PWRM_vFinishActivity(PWRM_teActivity eActivity);
+uint16 PWRM_u16GetActivityCount(PWRM_teActivity eActivity);
+void PWRM_vSetDeepestMode(PWRM_teMode eMode);
+PWRM_teMode PWRM_eSelectMode(bool_t bDeepSleep);
+void PWRM_vIdle(bool_t bTimer, bool_t bDeepSleep);
+#ifdef PWRM_SUPPORT_STATISTICS
+void PWRM_vGetResidency(PWRM_teMode eMode, PWRM_tsResidency *psResidency);
+void PWRM_vResetResidency(void);
+void PWRM_vDumpResidency(void);
+#endif
+
+/****************************************************************************/
+/***        External Variables                                            ***/
+/****************************************************************************/
+
+/****************************************************************************/
+/****************************************************************************/
+/****************************************************************************/
+
+#endif /*POWERMANAGER_H_*/
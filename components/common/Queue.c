@@ -37,7 +37,12 @@
 
 #include "chip_selection.h"
 #include "Queue.h"
+#include "PowerManager.h"
+#include "port_mcu.h"
 //#include "dbg.h"
+#ifdef QUEUE_SUPPORT_STATISTICS
+#include "dbg.h"
+#endif
 
 /****************************************************************************/
 /***        Macro Definitions                                             ***/
@@ -49,6 +54,18 @@
 #define TRACE_QUEUE    FALSE
 #endif
 
+/* Address of slot tIndex in the storage area */
+#define QUEUE_SLOT(psQueue, tIndex)  ((psQueue)->pvHead + ((uint32)(tIndex) * (psQueue)->u16ItemSize))
+
+#ifdef QUEUE_SUPPORT_STATISTICS
+#define QUEUE_STATISTICS(psQueue, u32Sent, u32Failed)   QUEUE_vUpdateStatistics((psQueue), (u32Sent), (u32Failed))
+#else
+#define QUEUE_STATISTICS(psQueue, u32Sent, u32Failed)
+#endif
+
+/* Largest power of two that still fits the 16 bit free running SPSC indices */
+#define QUEUE_SPSC_MAX_LENGTH   (0x8000UL)
+
 /****************************************************************************/
 /***        Type Definitions                                              ***/
 /****************************************************************************/
@@ -57,11 +74,21 @@
 /***        Local Function Prototypes                                     ***/
 /****************************************************************************/
 
+static uint32 QUEUE_u32MakeRoom(tsQueue *psQueueHandle, uint32 u32NumItems);
+static void QUEUE_vDiscardOldest(tsQueue *psQueueHandle, uint32 u32NumItems);
+#ifdef QUEUE_SUPPORT_STATISTICS
+static void QUEUE_vUpdateStatistics(tsQueue *psQueueHandle, uint32 u32Sent, uint32 u32Failed);
+#endif
+
 
 /****************************************************************************/
 /***        Local Variables                                               ***/
 /****************************************************************************/
 
+#ifdef QUEUE_SUPPORT_STATISTICS
+static tsQueue *QUEUE_psRegistry = NULL;
+#endif
+
 
 /****************************************************************************/
 /***        Exported Functions                                            ***/
@@ -78,11 +105,32 @@ void QUEUE_vCreate ( tsQueue*       psQueueHandle,
                     uint8*          pu8StartQueue )
 {
         psQueueHandle->pvHead =  pu8StartQueue;
-        psQueueHandle->u32ItemSize =  u32ItemSize;
-        psQueueHandle->u32Length =  u32QueueLength;
-        psQueueHandle->pvWriteTo =  psQueueHandle->pvHead;
-        psQueueHandle->u32MessageWaiting =  0;
-        psQueueHandle->pvReadFrom =  psQueueHandle->pvHead;
+        psQueueHandle->u16ItemSize =  (uint16)u32ItemSize;
+        psQueueHandle->tLength =  (QUEUE_tIndex)u32QueueLength;
+        psQueueHandle->tWriteIndex =  0;
+        psQueueHandle->tMessageWaiting =  0;
+        psQueueHandle->tReadIndex =  0;
+        psQueueHandle->u8Policy = E_QUEUE_POLICY_REJECT_NEW;
+        psQueueHandle->u32DropCount = 0;
+        psQueueHandle->u32OverwriteCount = 0;
+#ifdef QUEUE_SUPPORT_STATISTICS
+        {
+            tsQueue *psQueue = QUEUE_psRegistry;
+
+            /* A queue created again (e.g. serial re-open) is registered once */
+            while ((psQueue != NULL) && (psQueue != psQueueHandle))
+            {
+                psQueue = (tsQueue *)psQueue->pvNext;
+            }
+            if (psQueue == NULL)
+            {
+                psQueueHandle->pcName = NULL;
+                psQueueHandle->pvNext = QUEUE_psRegistry;
+                QUEUE_psRegistry = psQueueHandle;
+            }
+            QUEUE_vResetStatistics(psQueueHandle);
+        }
+#endif
 //        DBG_vPrintf(TRACE_QUEUE, "QUEUE: Initialised a queue: Handle=%08x Length=%d ItemSize=%d\n", (uint32)psQueueHandle, u32QueueLength, u32ItemSize);
 
 }
@@ -93,27 +141,32 @@ bool_t QUEUE_bSend ( void*          pvQueueHandle,
 
     tsQueue *psQueueHandle = (tsQueue *)pvQueueHandle;
     bool bReturn = FALSE;
-    /*TODO: disable and save interrupt*/
-    
-    if(psQueueHandle->u32MessageWaiting >= psQueueHandle->u32Length)
+    uint8 u8State = PORTABLE_u8EnterCritical();
+
+    if(QUEUE_u32MakeRoom(psQueueHandle, 1) == 0)
     {
 //        DBG_vPrintf(TRACE_QUEUE, "QUEUE: Queue overflow: Handle=%08x\n", (uint32)pvQueueHandle);
+        QUEUE_STATISTICS(psQueueHandle, 0, 1);
     }
     else
     {        
-        if( psQueueHandle->pvWriteTo >= (psQueueHandle->pvHead+(psQueueHandle->u32Length*psQueueHandle->u32ItemSize)))
+        ( void ) memcpy( QUEUE_SLOT(psQueueHandle, psQueueHandle->tWriteIndex), pvItemToQueue, psQueueHandle->u16ItemSize );
+        if (++psQueueHandle->tWriteIndex == psQueueHandle->tLength)
         {
-             psQueueHandle->pvWriteTo = psQueueHandle->pvHead;
+            psQueueHandle->tWriteIndex = 0;
         }
-        ( void ) memcpy( psQueueHandle->pvWriteTo, pvItemToQueue, psQueueHandle->u32ItemSize );
-        psQueueHandle->u32MessageWaiting++;
-        psQueueHandle->pvWriteTo += psQueueHandle->u32ItemSize;
+        psQueueHandle->tMessageWaiting++;
+        QUEUE_STATISTICS(psQueueHandle, 1, 0);
         
-        /* TODO: Increase power manager activity count */
+        /* The queue is one activity of the power manager while it holds items */
+        if (psQueueHandle->tMessageWaiting == 1)
+        {
+            PWRM_vStartActivity(E_PWRM_ACTIVITY_QUEUE);
+        }
         
         bReturn = TRUE;
     }
-    /*TODO: restore interrupt*/
+    PORTABLE_vExitCritical(u8State);
     
     return bReturn;
 }
@@ -123,19 +176,21 @@ bool_t QUEUE_bReceive ( void*    pvQueueHandle,
 {
     tsQueue *psQueueHandle = (tsQueue *)pvQueueHandle;
     bool bReturn = FALSE;
-    /*TODO: disable and save interrupt*/
+    uint8 u8State = PORTABLE_u8EnterCritical();
 
-    if( psQueueHandle->u32MessageWaiting >  0)
+    if( psQueueHandle->tMessageWaiting >  0)
     {
-        if( psQueueHandle->pvReadFrom >= (psQueueHandle->pvHead+(psQueueHandle->u32Length*psQueueHandle->u32ItemSize) ))
+        ( void ) memcpy( pvItemFromQueue, QUEUE_SLOT(psQueueHandle, psQueueHandle->tReadIndex), psQueueHandle->u16ItemSize );
+        if (++psQueueHandle->tReadIndex == psQueueHandle->tLength)
         {
-            psQueueHandle->pvReadFrom = psQueueHandle->pvHead;
+            psQueueHandle->tReadIndex = 0;
         }
-        ( void ) memcpy( pvItemFromQueue, psQueueHandle->pvReadFrom, psQueueHandle->u32ItemSize );
-        psQueueHandle->pvReadFrom += psQueueHandle->u32ItemSize;
-        psQueueHandle->u32MessageWaiting--;
+        psQueueHandle->tMessageWaiting--;
         
-        /*TODO: Decrease power manager activity count */
+        if (psQueueHandle->tMessageWaiting == 0)
+        {
+            PWRM_vFinishActivity(E_PWRM_ACTIVITY_QUEUE);
+        }
         
         bReturn = TRUE;        
     }
@@ -143,7 +198,7 @@ bool_t QUEUE_bReceive ( void*    pvQueueHandle,
     {
         bReturn =  FALSE;
     }
-    /*TODO: restore interrupt*/
+    PORTABLE_vExitCritical(u8State);
     
     return bReturn;
 }
@@ -152,9 +207,9 @@ bool_t QUEUE_bIsEmpty ( void*    pu8QueueHandle )
 {
     tsQueue *psQueueHandle = (tsQueue *)pu8QueueHandle;
     bool bReturn = FALSE;
-    /*TODO: disable and save interrupt*/
+    uint8 u8State = PORTABLE_u8EnterCritical();
 
-    if (psQueueHandle->u32MessageWaiting == 0)
+    if (psQueueHandle->tMessageWaiting == 0)
     {
         bReturn = TRUE;
     }
@@ -162,7 +217,7 @@ bool_t QUEUE_bIsEmpty ( void*    pu8QueueHandle )
     {
         bReturn = FALSE;
     }
-    /*TODO: restore interrupt*/
+    PORTABLE_vExitCritical(u8State);
 
     return (bReturn);
 }
@@ -171,15 +226,466 @@ bool_t QUEUE_bIsEmpty ( void*    pu8QueueHandle )
 uint32 QUEUE_u32GetQueueSize ( void*    pu8QueueHandle )
 {
     tsQueue *psQueueHandle = (tsQueue *)pu8QueueHandle;
-    return psQueueHandle->u32Length;
+    return psQueueHandle->tLength;
 }
 
 uint32 QUEUE_u32GetQueueMessageWaiting ( void*    pu8QueueHandle )
 {
     tsQueue *psQueueHandle = (tsQueue *)pu8QueueHandle;
-    return psQueueHandle->u32MessageWaiting;
+    return psQueueHandle->tMessageWaiting;
+}
+
+/* Drops the items of a created queue, ending the activity they held. Call it
+ * before a live queue is created again, QUEUE_vCreate does not look at the
+ * previous contents. */
+void QUEUE_vFlush ( void*    pvQueueHandle )
+{
+    tsQueue *psQueueHandle = (tsQueue *)pvQueueHandle;
+    uint8 u8State = PORTABLE_u8EnterCritical();
+
+    if (psQueueHandle->tMessageWaiting != 0)
+    {
+        psQueueHandle->tMessageWaiting = 0;
+        psQueueHandle->tReadIndex = psQueueHandle->tWriteIndex;
+        PWRM_vFinishActivity(E_PWRM_ACTIVITY_QUEUE);
+    }
+
+    PORTABLE_vExitCritical(u8State);
 }
 
+/* Moves up to u32NumItems items into the queue with at most two memcpy calls,
+ * one up to the end of the storage area and one from its beginning.
+ * Returns the number of items accepted; under E_QUEUE_POLICY_OVERWRITE_OLDEST
+ * that is always u32NumItems even if older ones were overwritten. Like every
+ * tsQueue call it runs in a critical section, here including the copies, so
+ * batches to or from a queue an ISR feeds are best kept short. */
+uint32 QUEUE_u32SendMany ( void*          pvQueueHandle,
+                          const void*    pvItemsToQueue,
+                          uint32         u32NumItems )
+{
+    tsQueue *psQueueHandle = (tsQueue *)pvQueueHandle;
+    const uint8 *pu8Items = (const uint8 *)pvItemsToQueue;
+    uint32 u32Count;
+    uint32 u32Bytes;
+    uint32 u32Accepted;
+#ifdef QUEUE_SUPPORT_STATISTICS
+    uint32 u32Requested = u32NumItems;
+#endif
+    uint8 u8State = PORTABLE_u8EnterCritical();
+
+    /* Only the newest tLength items can survive an overwrite */
+    if ((psQueueHandle->u8Policy == E_QUEUE_POLICY_OVERWRITE_OLDEST) &&
+        (u32NumItems > psQueueHandle->tLength))
+    {
+        pu8Items += (u32NumItems - psQueueHandle->tLength) * psQueueHandle->u16ItemSize;
+        psQueueHandle->u32OverwriteCount += u32NumItems - psQueueHandle->tLength;
+        u32Accepted = u32NumItems;
+        u32NumItems = QUEUE_u32MakeRoom(psQueueHandle, psQueueHandle->tLength);
+    }
+    else
+    {
+        u32NumItems = QUEUE_u32MakeRoom(psQueueHandle, u32NumItems);
+        u32Accepted = u32NumItems;
+    }
+    QUEUE_STATISTICS(psQueueHandle, 0, u32Requested - u32Accepted);
+
+    if (u32NumItems > 0)
+    {
+        /* First segment, up to the end of the storage area */
+        u32Count = (uint32)(psQueueHandle->tLength - psQueueHandle->tWriteIndex);
+        if (u32Count > u32NumItems)
+        {
+            u32Count = u32NumItems;
+        }
+        u32Bytes = u32Count * psQueueHandle->u16ItemSize;
+        ( void ) memcpy( QUEUE_SLOT(psQueueHandle, psQueueHandle->tWriteIndex), pu8Items, u32Bytes );
+        psQueueHandle->tWriteIndex += (QUEUE_tIndex)u32Count;
+        if (psQueueHandle->tWriteIndex == psQueueHandle->tLength)
+        {
+            psQueueHandle->tWriteIndex = 0;
+        }
+
+        /* Second segment, wrapped around to the beginning */
+        if (u32NumItems > u32Count)
+        {
+            pu8Items += u32Bytes;
+            u32Count = u32NumItems - u32Count;
+            ( void ) memcpy( psQueueHandle->pvHead, pu8Items, u32Count * psQueueHandle->u16ItemSize );
+            psQueueHandle->tWriteIndex = (QUEUE_tIndex)u32Count;
+        }
+
+        psQueueHandle->tMessageWaiting += (QUEUE_tIndex)u32NumItems;
+        QUEUE_STATISTICS(psQueueHandle, u32NumItems, 0);
+
+        if (psQueueHandle->tMessageWaiting == (QUEUE_tIndex)u32NumItems)
+        {
+            PWRM_vStartActivity(E_PWRM_ACTIVITY_QUEUE);
+        }
+    }
+    PORTABLE_vExitCritical(u8State);
+
+    return u32Accepted;
+}
+
+/* Moves up to u32MaxItems items out of the queue with at most two memcpy calls.
+ * Returns the number of items actually received. */
+uint32 QUEUE_u32ReceiveMany ( void*    pvQueueHandle,
+                             void*    pvItemsFromQueue,
+                             uint32   u32MaxItems )
+{
+    tsQueue *psQueueHandle = (tsQueue *)pvQueueHandle;
+    uint8 *pu8Items = (uint8 *)pvItemsFromQueue;
+    uint32 u32Count;
+    uint32 u32Bytes;
+    uint8 u8State = PORTABLE_u8EnterCritical();
+
+    if (u32MaxItems > psQueueHandle->tMessageWaiting)
+    {
+        u32MaxItems = psQueueHandle->tMessageWaiting;
+    }
+
+    if (u32MaxItems > 0)
+    {
+        /* First segment, up to the end of the storage area */
+        u32Count = (uint32)(psQueueHandle->tLength - psQueueHandle->tReadIndex);
+        if (u32Count > u32MaxItems)
+        {
+            u32Count = u32MaxItems;
+        }
+        u32Bytes = u32Count * psQueueHandle->u16ItemSize;
+        ( void ) memcpy( pu8Items, QUEUE_SLOT(psQueueHandle, psQueueHandle->tReadIndex), u32Bytes );
+        psQueueHandle->tReadIndex += (QUEUE_tIndex)u32Count;
+        if (psQueueHandle->tReadIndex == psQueueHandle->tLength)
+        {
+            psQueueHandle->tReadIndex = 0;
+        }
+
+        /* Second segment, wrapped around to the beginning */
+        if (u32MaxItems > u32Count)
+        {
+            pu8Items += u32Bytes;
+            u32Count = u32MaxItems - u32Count;
+            ( void ) memcpy( pu8Items, psQueueHandle->pvHead, u32Count * psQueueHandle->u16ItemSize );
+            psQueueHandle->tReadIndex = (QUEUE_tIndex)u32Count;
+        }
+
+        psQueueHandle->tMessageWaiting -= (QUEUE_tIndex)u32MaxItems;
+
+        if (psQueueHandle->tMessageWaiting == 0)
+        {
+            PWRM_vFinishActivity(E_PWRM_ACTIVITY_QUEUE);
+        }
+    }
+    PORTABLE_vExitCritical(u8State);
+
+    return u32MaxItems;
+}
+
+/* Zero copy access. QUEUE_pvReserve returns the next free slot (NULL when the
+ * queue is full) so the producer can build the item in place; the item is only
+ * visible to the consumer after QUEUE_vCommit. QUEUE_pvPeek returns the oldest
+ * item (NULL when empty) and QUEUE_vConsume releases it. Each call is a
+ * critical section but the slot is not claimed in between: a producer using
+ * QUEUE_pvReserve must be the only one sending to the queue, and a consumer
+ * using QUEUE_pvPeek the only one receiving from it. */
+void* QUEUE_pvReserve ( void*    pvQueueHandle )
+{
+    tsQueue *psQueueHandle = (tsQueue *)pvQueueHandle;
+    void *pvSlot = NULL;
+    uint8 u8State = PORTABLE_u8EnterCritical();
+
+    if (QUEUE_u32MakeRoom(psQueueHandle, 1) != 0)
+    {
+        pvSlot = QUEUE_SLOT(psQueueHandle, psQueueHandle->tWriteIndex);
+    }
+    else
+    {
+        QUEUE_STATISTICS(psQueueHandle, 0, 1);
+    }
+    PORTABLE_vExitCritical(u8State);
+
+    return pvSlot;
+}
+
+void QUEUE_vCommit ( void*    pvQueueHandle )
+{
+    tsQueue *psQueueHandle = (tsQueue *)pvQueueHandle;
+    uint8 u8State = PORTABLE_u8EnterCritical();
+
+    if (psQueueHandle->tMessageWaiting < psQueueHandle->tLength)
+    {
+        if (++psQueueHandle->tWriteIndex == psQueueHandle->tLength)
+        {
+            psQueueHandle->tWriteIndex = 0;
+        }
+        psQueueHandle->tMessageWaiting++;
+        QUEUE_STATISTICS(psQueueHandle, 1, 0);
+
+        if (psQueueHandle->tMessageWaiting == 1)
+        {
+            PWRM_vStartActivity(E_PWRM_ACTIVITY_QUEUE);
+        }
+    }
+    PORTABLE_vExitCritical(u8State);
+}
+
+void* QUEUE_pvPeek ( void*    pvQueueHandle )
+{
+    tsQueue *psQueueHandle = (tsQueue *)pvQueueHandle;
+    void *pvItem = NULL;
+    uint8 u8State = PORTABLE_u8EnterCritical();
+
+    if (psQueueHandle->tMessageWaiting > 0)
+    {
+        pvItem = QUEUE_SLOT(psQueueHandle, psQueueHandle->tReadIndex);
+    }
+    PORTABLE_vExitCritical(u8State);
+
+    return pvItem;
+}
+
+void QUEUE_vConsume ( void*    pvQueueHandle )
+{
+    tsQueue *psQueueHandle = (tsQueue *)pvQueueHandle;
+    uint8 u8State = PORTABLE_u8EnterCritical();
+
+    if (psQueueHandle->tMessageWaiting > 0)
+    {
+        if (++psQueueHandle->tReadIndex == psQueueHandle->tLength)
+        {
+            psQueueHandle->tReadIndex = 0;
+        }
+        psQueueHandle->tMessageWaiting--;
+
+        if (psQueueHandle->tMessageWaiting == 0)
+        {
+            PWRM_vFinishActivity(E_PWRM_ACTIVITY_QUEUE);
+        }
+    }
+    PORTABLE_vExitCritical(u8State);
+}
+
+void QUEUE_vSetPolicy ( void*             pvQueueHandle,
+                        QUEUE_tePolicy    ePolicy )
+{
+    tsQueue *psQueueHandle = (tsQueue *)pvQueueHandle;
+    psQueueHandle->u8Policy = (uint8)ePolicy;
+}
+
+uint32 QUEUE_u32GetDropCount ( void*    pvQueueHandle )
+{
+    tsQueue *psQueueHandle = (tsQueue *)pvQueueHandle;
+    return psQueueHandle->u32DropCount;
+}
+
+uint32 QUEUE_u32GetOverwriteCount ( void*    pvQueueHandle )
+{
+    tsQueue *psQueueHandle = (tsQueue *)pvQueueHandle;
+    return psQueueHandle->u32OverwriteCount;
+}
+
+#ifdef QUEUE_SUPPORT_STATISTICS
+void QUEUE_vSetName ( void*          pvQueueHandle,
+                      const char*    pcName )
+{
+    tsQueue *psQueueHandle = (tsQueue *)pvQueueHandle;
+    psQueueHandle->pcName = pcName;
+}
+
+void QUEUE_vResetStatistics ( void*    pvQueueHandle )
+{
+    tsQueue *psQueueHandle = (tsQueue *)pvQueueHandle;
+
+    psQueueHandle->u32HighWater = psQueueHandle->tMessageWaiting;
+    psQueueHandle->u32SendFail = 0;
+    psQueueHandle->u32Throughput = 0;
+    memset(psQueueHandle->au16Histogram, 0, sizeof(psQueueHandle->au16Histogram));
+}
+
+void QUEUE_vDumpStatistics ( void )
+{
+    tsQueue *psQueue;
+    int n;
+
+    for (psQueue = QUEUE_psRegistry; psQueue != NULL; psQueue = (tsQueue *)psQueue->pvNext)
+    {
+        DBG_vPrintf(TRUE, "QUEUE: %s Length=%lu HighWater=%lu Waiting=%lu Sent=%lu Fail=%lu Drop=%lu Overwrite=%lu Histogram=",
+                    (psQueue->pcName != NULL) ? psQueue->pcName : "?",
+                    (unsigned long)psQueue->tLength,
+                    (unsigned long)psQueue->u32HighWater,
+                    (unsigned long)psQueue->tMessageWaiting,
+                    (unsigned long)psQueue->u32Throughput,
+                    (unsigned long)psQueue->u32SendFail,
+                    (unsigned long)psQueue->u32DropCount,
+                    (unsigned long)psQueue->u32OverwriteCount);
+
+        for (n = 0; n < QUEUE_HISTOGRAM_BINS; n++)
+        {
+            DBG_vPrintf(TRUE, " %u", psQueue->au16Histogram[n]);
+        }
+        DBG_vPrintf(TRUE, "\n");
+    }
+}
+#endif
+
+/* Lock free single producer / single consumer queue. Only one context may send
+ * and only one context may receive; either of them may be an interrupt. */
+bool_t QUEUE_bSpscCreate ( tsQueueSpsc*   psQueueHandle,
+                          const uint32   u32QueueLength,
+                          const uint32   u32ItemSize,
+                          uint8*         pu8StartQueue )
+{
+    /* Index masking requires a power of two length */
+    if ((u32QueueLength == 0) ||
+        (u32QueueLength > QUEUE_SPSC_MAX_LENGTH) ||
+        ((u32QueueLength & (u32QueueLength - 1)) != 0))
+    {
+        return FALSE;
+    }
+
+    psQueueHandle->pvHead = pu8StartQueue;
+    psQueueHandle->u32ItemSize = u32ItemSize;
+    psQueueHandle->u16Mask = (uint16)(u32QueueLength - 1);
+    psQueueHandle->u16WriteIndex = 0;
+    psQueueHandle->u16ReadIndex = 0;
+
+    return TRUE;
+}
+
+bool_t QUEUE_bSpscSend ( void*          pvQueueHandle,
+                        const void*    pvItemToQueue )
+{
+    tsQueueSpsc *psQueueHandle = (tsQueueSpsc *)pvQueueHandle;
+    uint16 u16Write = psQueueHandle->u16WriteIndex;
+
+    /* The read index is the only shared value the producer looks at */
+    if ((uint16)(u16Write - psQueueHandle->u16ReadIndex) > psQueueHandle->u16Mask)
+    {
+        return FALSE;
+    }
+
+    ( void ) memcpy( psQueueHandle->pvHead + ((uint32)(u16Write & psQueueHandle->u16Mask) * psQueueHandle->u32ItemSize),
+                     pvItemToQueue, psQueueHandle->u32ItemSize );
+
+    /* The item must be visible before the consumer can see the new index */
+    QUEUE_MEMORY_BARRIER();
+    psQueueHandle->u16WriteIndex = (uint16)(u16Write + 1);
+
+    return TRUE;
+}
+
+bool_t QUEUE_bSpscReceive ( void*    pvQueueHandle,
+                           void*    pvItemFromQueue )
+{
+    tsQueueSpsc *psQueueHandle = (tsQueueSpsc *)pvQueueHandle;
+    uint16 u16Read = psQueueHandle->u16ReadIndex;
+
+    if (u16Read == psQueueHandle->u16WriteIndex)
+    {
+        return FALSE;
+    }
+
+    /* Do not read the item before the write index that published it */
+    QUEUE_MEMORY_BARRIER();
+    ( void ) memcpy( pvItemFromQueue,
+                     psQueueHandle->pvHead + ((uint32)(u16Read & psQueueHandle->u16Mask) * psQueueHandle->u32ItemSize),
+                     psQueueHandle->u32ItemSize );
+
+    /* The slot must be read out before the producer may reuse it */
+    QUEUE_MEMORY_BARRIER();
+    psQueueHandle->u16ReadIndex = (uint16)(u16Read + 1);
+
+    return TRUE;
+}
+
+bool_t QUEUE_bSpscIsEmpty ( void*    pvQueueHandle )
+{
+    tsQueueSpsc *psQueueHandle = (tsQueueSpsc *)pvQueueHandle;
+    return (psQueueHandle->u16ReadIndex == psQueueHandle->u16WriteIndex);
+}
+
+uint32 QUEUE_u32SpscGetMessageWaiting ( void*    pvQueueHandle )
+{
+    tsQueueSpsc *psQueueHandle = (tsQueueSpsc *)pvQueueHandle;
+    return (uint16)(psQueueHandle->u16WriteIndex - psQueueHandle->u16ReadIndex);
+}
+
+/* Applies the queue policy for a send of u32NumItems items and returns how many
+ * of them can be stored. Under E_QUEUE_POLICY_OVERWRITE_OLDEST the oldest items
+ * are discarded so that all of them fit (u32NumItems must not exceed tLength). */
+static uint32 QUEUE_u32MakeRoom(tsQueue *psQueueHandle, uint32 u32NumItems)
+{
+    uint32 u32Free = (uint32)(psQueueHandle->tLength - psQueueHandle->tMessageWaiting);
+
+    if (u32NumItems <= u32Free)
+    {
+        return u32NumItems;
+    }
+
+    switch (psQueueHandle->u8Policy)
+    {
+    case E_QUEUE_POLICY_OVERWRITE_OLDEST:
+        QUEUE_vDiscardOldest(psQueueHandle, u32NumItems - u32Free);
+        return u32NumItems;
+
+    case E_QUEUE_POLICY_DROP_COUNT:
+        psQueueHandle->u32DropCount += u32NumItems - u32Free;
+        break;
+
+    default:
+        break;
+    }
+
+    return u32Free;
+}
+
+static void QUEUE_vDiscardOldest(tsQueue *psQueueHandle, uint32 u32NumItems)
+{
+    uint32 u32Index = (uint32)psQueueHandle->tReadIndex + u32NumItems;
+
+    if (u32Index >= psQueueHandle->tLength)
+    {
+        u32Index -= psQueueHandle->tLength;
+    }
+    psQueueHandle->tReadIndex = (QUEUE_tIndex)u32Index;
+    psQueueHandle->tMessageWaiting -= (QUEUE_tIndex)u32NumItems;
+    psQueueHandle->u32OverwriteCount += u32NumItems;
+
+    /* Emptied to make room for as many new items, which start it again */
+    if (psQueueHandle->tMessageWaiting == 0)
+    {
+        PWRM_vFinishActivity(E_PWRM_ACTIVITY_QUEUE);
+    }
+}
+
+#ifdef QUEUE_SUPPORT_STATISTICS
+static void QUEUE_vUpdateStatistics(tsQueue *psQueueHandle, uint32 u32Sent, uint32 u32Failed)
+{
+    uint16 *pu16Bin;
+
+    psQueueHandle->u32SendFail += u32Failed;
+
+    if (u32Sent == 0)
+    {
+        return;
+    }
+
+    psQueueHandle->u32Throughput += u32Sent;
+
+    if (psQueueHandle->tMessageWaiting > psQueueHandle->u32HighWater)
+    {
+        psQueueHandle->u32HighWater = psQueueHandle->tMessageWaiting;
+    }
+
+    /* Saturating counters keep the histogram small on 8 bit targets */
+    pu16Bin = &psQueueHandle->au16Histogram[((uint32)psQueueHandle->tMessageWaiting * QUEUE_HISTOGRAM_BINS) / ((uint32)psQueueHandle->tLength + 1)];
+    if (*pu16Bin < 0xFFFF)
+    {
+        (*pu16Bin)++;
+    }
+}
+#endif
+
 /****************************************************************************/
 /***        END OF FILE                                                   ***/
 /****************************************************************************/
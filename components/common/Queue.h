@@ -38,22 +38,115 @@
 #include "chip_selection.h"
 #include "string.h"
 
+/* Orders an item copy against the publication of a lock free queue index.
+ * Cortex-M3 may reorder stores to normal memory so a DMB is required. The STM8
+ * core is in-order and the indices are volatile, so only the compiler must be
+ * kept from moving the copy, which the out-of-line memcpy call already does. */
+#if (defined STM32F10X_MD)
+#define QUEUE_MEMORY_BARRIER()  __DMB()
+#elif (defined __GNUC__)
+#define QUEUE_MEMORY_BARRIER()  __sync_synchronize()
+#else
+#define QUEUE_MEMORY_BARRIER()
+#endif
+
+/* Define QUEUE_SUPPORT_STATISTICS to keep per queue usage figures and register
+ * every tsQueue so that QUEUE_vDumpStatistics can print them all */
+#ifndef QUEUE_HISTOGRAM_BINS
+#define QUEUE_HISTOGRAM_BINS    (8)
+#endif
+
+/* Type of the tsQueue length, item count and slot indices: 8, 16 or 32 bits.
+ * On STM8 a 16 bit index is compared and incremented in one instruction where a
+ * 32 bit one takes several, and the queue header shrinks accordingly. The queue
+ * length passed to QUEUE_vCreate must fit the chosen type. */
+#ifndef QUEUE_INDEX_WIDTH
+#if (defined STM32F10X_MD)
+#define QUEUE_INDEX_WIDTH       (32)
+#else
+#define QUEUE_INDEX_WIDTH       (16)
+#endif
+#endif
+
+#if (QUEUE_INDEX_WIDTH == 8)
+typedef uint8  QUEUE_tIndex;
+#elif (QUEUE_INDEX_WIDTH == 16)
+typedef uint16 QUEUE_tIndex;
+#elif (QUEUE_INDEX_WIDTH == 32)
+typedef uint32 QUEUE_tIndex;
+#else
+#error "QUEUE_INDEX_WIDTH must be 8, 16 or 32"
+#endif
+
+/* What QUEUE_bSend, QUEUE_u32SendMany and QUEUE_pvReserve do when the queue is full */
+typedef enum
+{
+    E_QUEUE_POLICY_REJECT_NEW,         /*< The new item is refused (default). */
+    E_QUEUE_POLICY_OVERWRITE_OLDEST,   /*< The oldest item is discarded to make room, counted in u32OverwriteCount. */
+    E_QUEUE_POLICY_DROP_COUNT,         /*< The new item is refused and counted in u32DropCount. */
+} QUEUE_tePolicy;
+
 typedef struct
 {
-    uint32 u32Length;                  /*< The length of the queue defined as the number of items it will hold, not the number of bytes. */
-    uint32 u32ItemSize;                /*< The size of each items that the queue will hold. */
-    uint32 u32MessageWaiting;
     uint8  *pvHead;                    /*< Points to the beginning of the queue storage area. */
-    uint8  *pvWriteTo;                 /*< Points to the free next place in the storage area. */
-    uint8  *pvReadFrom;                /*< Points to the free next place in the storage area. */
+    uint16 u16ItemSize;                /*< The size of each items that the queue will hold. */
+    QUEUE_tIndex tLength;              /*< The length of the queue defined as the number of items it will hold, not the number of bytes. */
+    QUEUE_tIndex tMessageWaiting;      /*< Number of items currently held. */
+    QUEUE_tIndex tWriteIndex;          /*< Slot the next item is written to, 0..tLength-1. */
+    QUEUE_tIndex tReadIndex;           /*< Slot the next item is read from, 0..tLength-1. */
+    uint8  u8Policy;                   /*< QUEUE_tePolicy applied when the queue is full. */
+    uint32 u32DropCount;               /*< Number of new items refused under E_QUEUE_POLICY_DROP_COUNT. */
+    uint32 u32OverwriteCount;          /*< Number of old items discarded under E_QUEUE_POLICY_OVERWRITE_OLDEST. */
+#ifdef QUEUE_SUPPORT_STATISTICS
+    const char *pcName;                /*< Name printed by QUEUE_vDumpStatistics. */
+    void   *pvNext;                    /*< Next queue in the statistics registry. */
+    uint32 u32HighWater;               /*< Largest number of items ever waiting. */
+    uint32 u32SendFail;                /*< Items that could not be queued. */
+    uint32 u32Throughput;              /*< Items queued since creation. */
+    uint16 au16Histogram[QUEUE_HISTOGRAM_BINS];    /*< Occupancy after each send, bin n covers n/BINS..(n+1)/BINS of the length. */
+#endif
 }tsQueue;
 
+/* Single producer / single consumer queue. The producer only writes u16WriteIndex
+ * and the consumer only writes u16ReadIndex, so one side may be an ISR without
+ * any critical section. Both indices are free running and 16 bits wide so that
+ * they are loaded and stored with a single instruction on STM8 and Cortex-M. */
+typedef struct
+{
+    volatile uint16 u16WriteIndex;     /*< Free running write index, modified by the producer only. */
+    volatile uint16 u16ReadIndex;      /*< Free running read index, modified by the consumer only. */
+    uint16 u16Mask;                    /*< Length - 1, the length must be a power of two. */
+    uint32 u32ItemSize;                /*< The size of each items that the queue will hold. */
+    uint8  *pvHead;                    /*< Points to the beginning of the queue storage area. */
+}tsQueueSpsc;
+
 void QUEUE_vCreate (tsQueue *psQueueHandle, const uint32 uiQueueLength, const uint32 uiItemSize, uint8* pu8StartQueue);
 bool_t QUEUE_bSend(void *pvQueueHandle, const void *pvItemToQueue);
 bool_t QUEUE_bReceive(void *pvQueueHandle, void *pvItemFromQueue);
 bool_t QUEUE_bIsEmpty(void *pvQueueHandle);
 uint32 QUEUE_u32GetQueueSize(void *pvQueueHandle);
 uint32 QUEUE_u32GetQueueMessageWaiting ( void*    pu8QueueHandle );
+void QUEUE_vFlush(void *pvQueueHandle);
+uint32 QUEUE_u32SendMany(void *pvQueueHandle, const void *pvItemsToQueue, uint32 u32NumItems);
+uint32 QUEUE_u32ReceiveMany(void *pvQueueHandle, void *pvItemsFromQueue, uint32 u32MaxItems);
+void* QUEUE_pvReserve(void *pvQueueHandle);
+void QUEUE_vCommit(void *pvQueueHandle);
+void* QUEUE_pvPeek(void *pvQueueHandle);
+void QUEUE_vConsume(void *pvQueueHandle);
+void QUEUE_vSetPolicy(void *pvQueueHandle, QUEUE_tePolicy ePolicy);
+uint32 QUEUE_u32GetDropCount(void *pvQueueHandle);
+uint32 QUEUE_u32GetOverwriteCount(void *pvQueueHandle);
+#ifdef QUEUE_SUPPORT_STATISTICS
+void QUEUE_vSetName(void *pvQueueHandle, const char *pcName);
+void QUEUE_vResetStatistics(void *pvQueueHandle);
+void QUEUE_vDumpStatistics(void);
+#endif
+
+bool_t QUEUE_bSpscCreate(tsQueueSpsc *psQueueHandle, const uint32 u32QueueLength, const uint32 u32ItemSize, uint8* pu8StartQueue);
+bool_t QUEUE_bSpscSend(void *pvQueueHandle, const void *pvItemToQueue);
+bool_t QUEUE_bSpscReceive(void *pvQueueHandle, void *pvItemFromQueue);
+bool_t QUEUE_bSpscIsEmpty(void *pvQueueHandle);
+uint32 QUEUE_u32SpscGetMessageWaiting(void *pvQueueHandle);
 #endif /*QUEUE_H_*/
 
 /****************************************************************************/
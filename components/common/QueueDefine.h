@@ -0,0 +1,110 @@
+/****************************************************************************
+ *
+ * MODULE: QueueDefine.h
+ *
+ * DESCRIPTION:
+ * Compile time typed queue generator
+ *
+ ****************************************************************************
+ *
+ * This software is owned by NXP B.V. and/or its supplier and is protected
+ * under applicable copyright laws. All rights are reserved. We grant You,
+ * and any third parties, a license to use this software solely and
+ * exclusively on NXP products [NXP Microcontrollers such as JN5168, JN5179].
+ * You, and any third parties must reproduce the copyright and warranty notice
+ * and any other legend of ownership on each copy or partial copy of the
+ * software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Copyright NXP B.V. 2016. All rights reserved
+ *
+ ***************************************************************************/
+
+#ifndef QUEUE_DEFINE_H_
+#define QUEUE_DEFINE_H_
+
+#include "chip_selection.h"
+#include "Queue.h"
+
+/****************************************************************************/
+/***        Macro Definitions                                             ***/
+/****************************************************************************/
+
+#define QUEUE_IS_POWER_OF_TWO(v)    (((v) > 0) && (((v) & ((v) - 1)) == 0))
+
+/* QUEUE_DEFINE(name, type, capacity) emits a file local queue of 'type' items:
+ *
+ *     QUEUE_DEFINE(APP_qButton, BUTTON_tsEvent, 8)
+ *
+ *     APP_qButton_bSend(&sEvent);
+ *     APP_qButton_bReceive(&sEvent);
+ *     APP_qButton_bIsEmpty();
+ *     APP_qButton_u16GetMessageWaiting();
+ *
+ * Storage and indices are static and zero initialised, so no create call is
+ * needed. Items are copied by plain assignment and positions are found by
+ * masking, so there are no runtime size fields and no memcpy. The capacity
+ * must be a power of two no larger than 32768; anything else fails to compile.
+ * Like tsQueueSpsc, one producer and one consumer may use the queue without a
+ * critical section, and either of them may be an ISR. */
+#define QUEUE_DEFINE(name, type, capacity)                                          \
+    typedef char name##_tCapacityCheck[(QUEUE_IS_POWER_OF_TWO(capacity) &&           \
+                                        ((capacity) <= 0x8000UL)) ? 1 : -1];         \
+                                                                                     \
+    static type name##_asItems[(capacity)];                                          \
+    static volatile uint16 name##_u16WriteIndex;                                     \
+    static volatile uint16 name##_u16ReadIndex;                                      \
+                                                                                     \
+    static inline bool_t name##_bSend(const type *psItem)                           \
+    {                                                                                \
+        uint16 u16Write = name##_u16WriteIndex;                                      \
+        if ((uint16)(u16Write - name##_u16ReadIndex) >= (uint16)(capacity))          \
+        {                                                                            \
+            return FALSE;                                                            \
+        }                                                                            \
+        name##_asItems[u16Write & ((capacity) - 1)] = *psItem;                       \
+        QUEUE_MEMORY_BARRIER();                                                      \
+        name##_u16WriteIndex = (uint16)(u16Write + 1);                               \
+        return TRUE;                                                                 \
+    }                                                                                \
+                                                                                     \
+    static inline bool_t name##_bReceive(type *psItem)                              \
+    {                                                                                \
+        uint16 u16Read = name##_u16ReadIndex;                                        \
+        if (u16Read == name##_u16WriteIndex)                                         \
+        {                                                                            \
+            return FALSE;                                                            \
+        }                                                                            \
+        QUEUE_MEMORY_BARRIER();                                                      \
+        *psItem = name##_asItems[u16Read & ((capacity) - 1)];                        \
+        QUEUE_MEMORY_BARRIER();                                                      \
+        name##_u16ReadIndex = (uint16)(u16Read + 1);                                 \
+        return TRUE;                                                                 \
+    }                                                                                \
+                                                                                     \
+    static inline bool_t name##_bIsEmpty(void)                                      \
+    {                                                                                \
+        return (name##_u16ReadIndex == name##_u16WriteIndex);                        \
+    }                                                                                \
+                                                                                     \
+    static inline uint16 name##_u16GetMessageWaiting(void)                          \
+    {                                                                                \
+        return (uint16)(name##_u16WriteIndex - name##_u16ReadIndex);                 \
+    }
+
+#endif /*QUEUE_DEFINE_H_*/
+
+/****************************************************************************/
+/***        END OF FILE                                                   ***/
+/****************************************************************************/
@@ -0,0 +1,176 @@
+/****************************************************************************
+ *
+ * MODULE:    QueueSet.c
+ *
+ * DESCRIPTION:
+ * Queue set: the main loop registers the queues it serves, and optionally the
+ * timer tick, then sleeps in QSET_u8Wait until one of them has work. Items are
+ * not removed; the caller receives from the returned member as usual.
+ *
+ * The members are checked with interrupts disabled and the core is put to sleep
+ * by PWRM_vIdle, which enables them again atomically, so an ISR producing an
+ * item after the check still wakes the core. Producers running in the main loop
+ * need no wake-up since the set is checked again before every sleep.
+ *
+ *
+ ****************************************************************************
+ *
+ * This software is owned by NXP B.V. and/or its supplier and is protected
+ * under applicable copyright laws. All rights are reserved. We grant You,
+ * and any third parties, a license to use this software solely and
+ * exclusively on NXP products [NXP Microcontrollers such as JN5168, JN5179].
+ * You, and any third parties must reproduce the copyright and warranty notice
+ * and any other legend of ownership on each copy or partial copy of the
+ * software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Copyright NXP B.V. 2016. All rights reserved
+ *
+ ***************************************************************************/
+
+
+/****************************************************************************/
+/***        Include files                                                 ***/
+/****************************************************************************/
+
+#include "chip_selection.h"
+#include "QueueSet.h"
+#include "Timer.h"
+#include "port_mcu.h"
+#include "PowerManager.h"
+#include "Defer.h"
+
+/****************************************************************************/
+/***        Macro Definitions                                             ***/
+/****************************************************************************/
+
+/****************************************************************************/
+/***        Type Definitions                                              ***/
+/****************************************************************************/
+
+/****************************************************************************/
+/***        Local Function Prototypes                                     ***/
+/****************************************************************************/
+
+/****************************************************************************/
+/***        Local Variables                                               ***/
+/****************************************************************************/
+
+/****************************************************************************/
+/***        Exported Functions                                            ***/
+/****************************************************************************/
+
+void QSET_vCreate ( tsQueueSet*    psSet )
+{
+    memset(psSet, 0, sizeof(tsQueueSet));
+}
+
+/* Adds a queue to the set; *pu8Member is the value QSET_u8Wait returns when
+ * this queue is not empty. Queues are checked in the order they were added. */
+bool_t QSET_bAddQueue ( tsQueueSet*    psSet,
+                        tsQueue*       psQueue,
+                        uint8*         pu8Member )
+{
+    if (psSet->u8NumQueues >= QSET_MAX_QUEUES)
+    {
+        return FALSE;
+    }
+
+    psSet->apsQueues[psSet->u8NumQueues] = psQueue;
+    *pu8Member = psSet->u8NumQueues;
+    psSet->u8NumQueues++;
+
+    return TRUE;
+}
+
+/* A pending timer tick ends the wait with QSET_MEMBER_TIMER. The tick timer
+ * stops in deep sleep, so the set only enters it while no running timer was
+ * opened with TIMER_FLAG_PREVENT_SLEEP. */
+void QSET_vAddTimer ( tsQueueSet*    psSet )
+{
+    psSet->bTimer = TRUE;
+}
+
+/* Work posted with DEFER_bPost ends the wait with QSET_MEMBER_DEFER; the
+ * caller runs it with DEFER_bRunOne or DEFER_vRun */
+void QSET_vAddDefer ( tsQueueSet*    psSet )
+{
+    psSet->bDefer = TRUE;
+}
+
+void QSET_vAllowDeepSleep ( tsQueueSet*    psSet,
+                            bool_t         bAllow )
+{
+    psSet->bDeepSleep = bAllow;
+}
+
+/* Returns the first member with work, deferred interrupt work before the timer
+ * tick and the tick before any queue, or QSET_MEMBER_NONE */
+uint8 QSET_u8Poll ( tsQueueSet*    psSet )
+{
+    uint8 n;
+
+    if (psSet->bDefer && DEFER_bIsPending())
+    {
+        return QSET_MEMBER_DEFER;
+    }
+
+    if (psSet->bTimer && TIMER_bIsTickPending())
+    {
+        return QSET_MEMBER_TIMER;
+    }
+
+    for (n = 0; n < psSet->u8NumQueues; n++)
+    {
+        if (!QUEUE_bIsEmpty(psSet->apsQueues[n]))
+        {
+            return n;
+        }
+    }
+
+    return QSET_MEMBER_NONE;
+}
+
+/* Sleeps until a member has work and returns it as QSET_u8Poll does. Every
+ * interrupt wakes the core, but the wait only ends once a member has work. */
+uint8 QSET_u8Wait ( tsQueueSet*    psSet )
+{
+    uint8 u8Member;
+
+    PORTABLE_vDisableInterrupts();
+
+    for (;;)
+    {
+        u8Member = QSET_u8Poll(psSet);
+        if (u8Member != QSET_MEMBER_NONE)
+        {
+            break;
+        }
+
+        /* Returns with interrupts disabled, after the waking ISR has run */
+        PWRM_vIdle(psSet->bTimer, psSet->bDeepSleep);
+    }
+
+    PORTABLE_vEnableInterrupts();
+
+    return u8Member;
+}
+
+/****************************************************************************/
+/***        Local Functions                                               ***/
+/****************************************************************************/
+
+/****************************************************************************/
+/***        END OF FILE                                                   ***/
+/****************************************************************************/
@@ -0,0 +1,83 @@
+/****************************************************************************
+ *
+ * MODULE: QueueSet.h
+ *
+ * DESCRIPTION:
+ * Wait on several queues and the timer tick at once
+ *
+ *
+ ****************************************************************************
+ *
+ * This software is owned by NXP B.V. and/or its supplier and is protected
+ * under applicable copyright laws. All rights are reserved. We grant You,
+ * and any third parties, a license to use this software solely and
+ * exclusively on NXP products [NXP Microcontrollers such as JN5168, JN5179].
+ * You, and any third parties must reproduce the copyright and warranty notice
+ * and any other legend of ownership on each copy or partial copy of the
+ * software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Copyright NXP B.V. 2016. All rights reserved
+ *
+ ***************************************************************************/
+
+#ifndef QUEUESET_H_
+#define QUEUESET_H_
+
+#include "chip_selection.h"
+#include "Queue.h"
+
+/****************************************************************************/
+/***        Macro Definitions                                             ***/
+/****************************************************************************/
+
+#ifndef QSET_MAX_QUEUES
+#define QSET_MAX_QUEUES         (4)
+#endif
+
+/* Returned by QSET_u8Wait / QSET_u8Poll instead of a queue index */
+#define QSET_MEMBER_DEFER       (0xFD)
+#define QSET_MEMBER_TIMER       (0xFE)
+#define QSET_MEMBER_NONE        (0xFF)
+
+/****************************************************************************/
+/***        Type Definitions                                              ***/
+/****************************************************************************/
+
+typedef struct
+{
+    tsQueue *apsQueues[QSET_MAX_QUEUES];
+    uint8  u8NumQueues;
+    bool_t bTimer;                     /*< TRUE: a pending timer tick also ends the wait. */
+    bool_t bDefer;                     /*< TRUE: deferred interrupt work also ends the wait. */
+    bool_t bDeepSleep;                 /*< TRUE: idle in the deepest mode PWRM_eSelectMode allows. */
+}tsQueueSet;
+
+/****************************************************************************/
+/***        Exported Functions                                            ***/
+/****************************************************************************/
+
+void QSET_vCreate(tsQueueSet *psSet);
+bool_t QSET_bAddQueue(tsQueueSet *psSet, tsQueue *psQueue, uint8 *pu8Member);
+void QSET_vAddTimer(tsQueueSet *psSet);
+void QSET_vAddDefer(tsQueueSet *psSet);
+void QSET_vAllowDeepSleep(tsQueueSet *psSet, bool_t bAllow);
+uint8 QSET_u8Poll(tsQueueSet *psSet);
+uint8 QSET_u8Wait(tsQueueSet *psSet);
+
+#endif /*QUEUESET_H_*/
+
+/****************************************************************************/
+/***        END OF FILE                                                   ***/
+/****************************************************************************/
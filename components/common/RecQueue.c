@@ -0,0 +1,222 @@
+/****************************************************************************
+ *
+ * MODULE:    RecQueue.c
+ *
+ * DESCRIPTION:
+ * Variable length record queue. Records of any size share one byte ring, each
+ * one prefixed by its length. A record never wraps: when it does not fit at the
+ * end of the storage area a padding marker is written and it goes to the start.
+ *
+ *
+ ****************************************************************************
+ *
+ * This software is owned by NXP B.V. and/or its supplier and is protected
+ * under applicable copyright laws. All rights are reserved. We grant You,
+ * and any third parties, a license to use this software solely and
+ * exclusively on NXP products [NXP Microcontrollers such as JN5168, JN5179].
+ * You, and any third parties must reproduce the copyright and warranty notice
+ * and any other legend of ownership on each copy or partial copy of the
+ * software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Copyright NXP B.V. 2016. All rights reserved
+ *
+ ***************************************************************************/
+
+
+/****************************************************************************/
+/***        Include files                                                 ***/
+/****************************************************************************/
+
+#include "chip_selection.h"
+#include "RecQueue.h"
+
+/****************************************************************************/
+/***        Macro Definitions                                             ***/
+/****************************************************************************/
+
+/****************************************************************************/
+/***        Type Definitions                                              ***/
+/****************************************************************************/
+
+/****************************************************************************/
+/***        Local Function Prototypes                                     ***/
+/****************************************************************************/
+
+static uint16 RECQ_u16ReadHeader(tsRecQueue *psRecQueue, uint16 u16Offset);
+static void RECQ_vWriteHeader(tsRecQueue *psRecQueue, uint16 u16Offset, uint16 u16Length);
+static void RECQ_vSkipPadding(tsRecQueue *psRecQueue);
+
+/****************************************************************************/
+/***        Local Variables                                               ***/
+/****************************************************************************/
+
+/****************************************************************************/
+/***        Exported Functions                                            ***/
+/****************************************************************************/
+
+void RECQ_vCreate ( tsRecQueue*    psRecQueue,
+                    uint8*         pu8StartQueue,
+                    uint16         u16Size )
+{
+    psRecQueue->pu8Head = pu8StartQueue;
+    /* Only whole alignment units are usable */
+    psRecQueue->u16Size = u16Size & ~(RECQ_ALIGNMENT - 1);
+    psRecQueue->u16Used = 0;
+    psRecQueue->u16ReadFrom = 0;
+    psRecQueue->u16WriteTo = 0;
+}
+
+bool_t RECQ_bPush ( tsRecQueue*    psRecQueue,
+                    const void*    pvRecord,
+                    uint16         u16Length )
+{
+    uint32 u32Total = RECQ_RECORD_SIZE(u16Length);
+    uint16 u16Total;
+
+    if ((u16Length > RECQ_MAX_LENGTH) ||
+        (u32Total > (uint32)(psRecQueue->u16Size - psRecQueue->u16Used)))
+    {
+        return FALSE;
+    }
+    u16Total = (uint16)u32Total;
+
+    /* An empty queue restarts at the beginning to get the largest contiguous space */
+    if (psRecQueue->u16Used == 0)
+    {
+        psRecQueue->u16ReadFrom = 0;
+        psRecQueue->u16WriteTo = 0;
+    }
+
+    if (psRecQueue->u16WriteTo >= psRecQueue->u16ReadFrom)
+    {
+        /* Free space is at the end and before the oldest record */
+        if ((psRecQueue->u16Size - psRecQueue->u16WriteTo) < u16Total)
+        {
+            if (psRecQueue->u16ReadFrom < u16Total)
+            {
+                return FALSE;
+            }
+
+            /* Pad out the end of the storage area and wrap around */
+            if ((psRecQueue->u16Size - psRecQueue->u16WriteTo) >= RECQ_HEADER_SIZE)
+            {
+                RECQ_vWriteHeader(psRecQueue, psRecQueue->u16WriteTo, RECQ_PAD_MARKER);
+            }
+            psRecQueue->u16Used += psRecQueue->u16Size - psRecQueue->u16WriteTo;
+            psRecQueue->u16WriteTo = 0;
+        }
+    }
+    else if ((psRecQueue->u16ReadFrom - psRecQueue->u16WriteTo) < u16Total)
+    {
+        /* Free space is only between the newest and the oldest record */
+        return FALSE;
+    }
+
+    RECQ_vWriteHeader(psRecQueue, psRecQueue->u16WriteTo, u16Length);
+    ( void ) memcpy( psRecQueue->pu8Head + psRecQueue->u16WriteTo + RECQ_HEADER_SIZE, pvRecord, u16Length );
+
+    psRecQueue->u16WriteTo += u16Total;
+    if (psRecQueue->u16WriteTo >= psRecQueue->u16Size)
+    {
+        psRecQueue->u16WriteTo = 0;
+    }
+    psRecQueue->u16Used += u16Total;
+
+    return TRUE;
+}
+
+void* RECQ_pvFront ( tsRecQueue*    psRecQueue,
+                     uint16*        pu16Length )
+{
+    RECQ_vSkipPadding(psRecQueue);
+
+    if (psRecQueue->u16Used == 0)
+    {
+        return NULL;
+    }
+
+    if (pu16Length != NULL)
+    {
+        *pu16Length = RECQ_u16ReadHeader(psRecQueue, psRecQueue->u16ReadFrom);
+    }
+
+    return psRecQueue->pu8Head + psRecQueue->u16ReadFrom + RECQ_HEADER_SIZE;
+}
+
+void RECQ_vPop ( tsRecQueue*    psRecQueue )
+{
+    uint16 u16Total;
+
+    RECQ_vSkipPadding(psRecQueue);
+
+    if (psRecQueue->u16Used == 0)
+    {
+        return;
+    }
+
+    u16Total = (uint16)RECQ_RECORD_SIZE(RECQ_u16ReadHeader(psRecQueue, psRecQueue->u16ReadFrom));
+
+    psRecQueue->u16ReadFrom += u16Total;
+    if (psRecQueue->u16ReadFrom >= psRecQueue->u16Size)
+    {
+        psRecQueue->u16ReadFrom = 0;
+    }
+    psRecQueue->u16Used -= u16Total;
+}
+
+bool_t RECQ_bIsEmpty ( tsRecQueue*    psRecQueue )
+{
+    return (psRecQueue->u16Used == 0);
+}
+
+/****************************************************************************/
+/***        Local Functions                                               ***/
+/****************************************************************************/
+
+static uint16 RECQ_u16ReadHeader(tsRecQueue *psRecQueue, uint16 u16Offset)
+{
+    /* Byte access, the header is not necessarily aligned on 8 bit targets */
+    return (uint16)(psRecQueue->pu8Head[u16Offset] |
+                    ((uint16)psRecQueue->pu8Head[u16Offset + 1] << 8));
+}
+
+static void RECQ_vWriteHeader(tsRecQueue *psRecQueue, uint16 u16Offset, uint16 u16Length)
+{
+    psRecQueue->pu8Head[u16Offset] = (uint8)(u16Length & 0xFF);
+    psRecQueue->pu8Head[u16Offset + 1] = (uint8)(u16Length >> 8);
+}
+
+static void RECQ_vSkipPadding(tsRecQueue *psRecQueue)
+{
+    uint16 u16Remaining = psRecQueue->u16Size - psRecQueue->u16ReadFrom;
+
+    if (psRecQueue->u16Used == 0)
+    {
+        return;
+    }
+
+    /* The writer wrapped around when the tail is too short for a header or
+     * holds the padding marker */
+    if ((u16Remaining < RECQ_HEADER_SIZE) ||
+        (RECQ_u16ReadHeader(psRecQueue, psRecQueue->u16ReadFrom) == RECQ_PAD_MARKER))
+    {
+        psRecQueue->u16Used -= u16Remaining;
+        psRecQueue->u16ReadFrom = 0;
+    }
+}
+
+/****************************************************************************/
+/***        END OF FILE                                                   ***/
+/****************************************************************************/
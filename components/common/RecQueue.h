@@ -0,0 +1,94 @@
+/****************************************************************************
+ *
+ * MODULE: RecQueue.h
+ *
+ * DESCRIPTION:
+ * Variable length record queue
+ *
+ *
+ ****************************************************************************
+ *
+ * This software is owned by NXP B.V. and/or its supplier and is protected
+ * under applicable copyright laws. All rights are reserved. We grant You,
+ * and any third parties, a license to use this software solely and
+ * exclusively on NXP products [NXP Microcontrollers such as JN5168, JN5179].
+ * You, and any third parties must reproduce the copyright and warranty notice
+ * and any other legend of ownership on each copy or partial copy of the
+ * software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Copyright NXP B.V. 2016. All rights reserved
+ *
+ ***************************************************************************/
+
+
+#ifndef RECQUEUE_H_
+#define RECQUEUE_H_
+
+#include "chip_selection.h"
+#include "string.h"
+
+/****************************************************************************/
+/***        Macro Definitions                                             ***/
+/****************************************************************************/
+
+/* Records are placed on this boundary so that their payload can be accessed
+ * as a structure. The storage area must be aligned the same way. */
+#ifndef RECQ_ALIGNMENT
+#if (defined STM32F10X_MD)
+#define RECQ_ALIGNMENT          (4)
+#else
+#define RECQ_ALIGNMENT          (1)
+#endif
+#endif
+
+#define RECQ_ALIGN(v)           (((v) + (RECQ_ALIGNMENT - 1)) & ~(RECQ_ALIGNMENT - 1))
+
+/* Every record starts with a 16 bit length; a length of RECQ_PAD_MARKER tells
+ * the reader that the rest of the storage area is unused and to wrap around. */
+#define RECQ_HEADER_SIZE        RECQ_ALIGN(2)
+#define RECQ_PAD_MARKER         (0xFFFF)
+#define RECQ_MAX_LENGTH         (RECQ_PAD_MARKER - 1)
+
+/* Bytes needed in the storage area by a record of u16Length bytes */
+#define RECQ_RECORD_SIZE(u16Length)     RECQ_ALIGN(RECQ_HEADER_SIZE + (uint32)(u16Length))
+
+/****************************************************************************/
+/***        Type Definitions                                              ***/
+/****************************************************************************/
+
+typedef struct
+{
+    uint16 u16Size;                    /*< Size of the storage area in bytes. */
+    uint16 u16Used;                    /*< Bytes taken by records and wrap-around padding. */
+    uint16 u16ReadFrom;                /*< Offset of the oldest record. */
+    uint16 u16WriteTo;                 /*< Offset of the next free byte. */
+    uint8  *pu8Head;                   /*< Points to the beginning of the storage area. */
+}tsRecQueue;
+
+/****************************************************************************/
+/***        Exported Functions                                            ***/
+/****************************************************************************/
+
+void RECQ_vCreate(tsRecQueue *psRecQueue, uint8 *pu8StartQueue, uint16 u16Size);
+bool_t RECQ_bPush(tsRecQueue *psRecQueue, const void *pvRecord, uint16 u16Length);
+void* RECQ_pvFront(tsRecQueue *psRecQueue, uint16 *pu16Length);
+void RECQ_vPop(tsRecQueue *psRecQueue);
+bool_t RECQ_bIsEmpty(tsRecQueue *psRecQueue);
+
+#endif /*RECQUEUE_H_*/
+
+/****************************************************************************/
+/***        END OF FILE                                                   ***/
+/****************************************************************************/
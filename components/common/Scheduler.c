@@ -0,0 +1,336 @@
+/****************************************************************************
+ *
+ * MODULE:    Scheduler.c
+ *
+ * DESCRIPTION:
+ * Run-to-completion scheduler: every task has a slot whose number is its
+ * priority and a ready bit. An event makes the task ready, through SCHED_vPost
+ * (also from an ISR) or because a queue bound to the task holds items, the
+ * timer tick is pending or an ISR deferred work with DEFER_bPost. SCHED_vRun
+ * calls the highest priority ready task, which returns when done, and sleeps
+ * when no task is ready.
+ *
+ * A dispatch costs one check of each bound queue and of the tick plus a scan
+ * of at most SCHED_MAX_TASKS ready bits, whatever the number of events. A
+ * task bound to a queue stays ready until the queue is empty; it may take one
+ * item per call so that higher priority tasks get in between.
+ *
+ * A task waiting in CO_BLOCK may call SCHED_vYield: it runs one ready task of
+ * higher priority than the one waiting, never the waiting task itself or one
+ * below it, so the nesting depth is bounded by the number of slots.
+ *
+ * The idle check is made with interrupts disabled and PWRM_vIdle enables
+ * them again atomically, as in QSET_u8Wait, so an event posted by an ISR after
+ * the check still wakes the core.
+ *
+ ****************************************************************************
+ *
+ * This software is owned by NXP B.V. and/or its supplier and is protected
+ * under applicable copyright laws. All rights are reserved. We grant You,
+ * and any third parties, a license to use this software solely and
+ * exclusively on NXP products [NXP Microcontrollers such as JN5168, JN5179].
+ * You, and any third parties must reproduce the copyright and warranty notice
+ * and any other legend of ownership on each copy or partial copy of the
+ * software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Copyright NXP B.V. 2016. All rights reserved
+ *
+ ***************************************************************************/
+
+
+/****************************************************************************/
+/***        Include files                                                 ***/
+/****************************************************************************/
+
+#include "chip_selection.h"
+#include "Scheduler.h"
+#include "Timer.h"
+#include "port_mcu.h"
+#include "PowerManager.h"
+#include "Defer.h"
+
+/****************************************************************************/
+/***        Macro Definitions                                             ***/
+/****************************************************************************/
+
+#define SCHED_BIT(u8Priority)   ((SCHED_tMask)(1U << (u8Priority)))
+
+/****************************************************************************/
+/***        Type Definitions                                              ***/
+/****************************************************************************/
+
+typedef struct
+{
+    SCHED_tpfTask  pfTask;
+    void           *pvParam;
+}SCHED_tsTask;
+
+typedef struct
+{
+    tsQueue        *psQueue;
+    SCHED_tMask    tTask;              /*< Ready bit of the task serving the queue. */
+}SCHED_tsQueue;
+
+typedef struct
+{
+    SCHED_tsTask   asTasks[SCHED_MAX_TASKS];
+    SCHED_tsQueue  asQueues[SCHED_MAX_QUEUES];
+    uint8          u8NumQueues;
+    SCHED_tMask    tTimerTask;         /*< Ready bit of the timer task, 0 without one. */
+    SCHED_tMask    tDeferTask;         /*< Ready bit of the deferred work task, 0 without one. */
+    SCHED_tMask    tTasks;             /*< Slots holding a task. */
+    volatile SCHED_tMask tReady;       /*< Tasks posted and not run yet. */
+    SCHED_tMask    tAllowed;           /*< Slots above the running task, all outside a task. */
+    bool_t         bDeepSleep;
+}SCHED_tsCommon;
+
+/****************************************************************************/
+/***        Local Function Prototypes                                     ***/
+/****************************************************************************/
+
+static void SCHED_vTimerTask(void *pvParam);
+static void SCHED_vDeferTask(void *pvParam);
+static SCHED_tMask SCHED_tPollSources(void);
+static void SCHED_vIdle(void);
+
+/****************************************************************************/
+/***        Local Variables                                               ***/
+/****************************************************************************/
+
+static SCHED_tsCommon SCHED_sCommon;
+
+/****************************************************************************/
+/***        Exported Functions                                            ***/
+/****************************************************************************/
+
+void SCHED_vInit ( void )
+{
+    memset(&SCHED_sCommon, 0, sizeof(SCHED_tsCommon));
+    SCHED_sCommon.tAllowed = (SCHED_tMask)~0U;
+}
+
+/* Puts pfTask in slot u8Priority, 0 being the highest priority. Fails when the
+ * slot does not exist or is taken. */
+bool_t SCHED_bAddTask ( uint8            u8Priority,
+                        SCHED_tpfTask    pfTask,
+                        void*            pvParam )
+{
+    if (u8Priority >= SCHED_MAX_TASKS || pfTask == NULL ||
+        SCHED_sCommon.asTasks[u8Priority].pfTask != NULL)
+    {
+        return FALSE;
+    }
+
+    SCHED_sCommon.asTasks[u8Priority].pvParam = pvParam;
+    SCHED_sCommon.asTasks[u8Priority].pfTask = pfTask;
+    SCHED_sCommon.tTasks |= SCHED_BIT(u8Priority);
+
+    return TRUE;
+}
+
+/* The task in slot u8Priority is ready whenever psQueue is not empty. A task
+ * may serve several queues. Fails when the slot holds no task yet. */
+bool_t SCHED_bBindQueue ( uint8      u8Priority,
+                          tsQueue*   psQueue )
+{
+    if (u8Priority >= SCHED_MAX_TASKS || SCHED_sCommon.u8NumQueues >= SCHED_MAX_QUEUES ||
+        SCHED_sCommon.asTasks[u8Priority].pfTask == NULL)
+    {
+        return FALSE;
+    }
+
+    SCHED_sCommon.asQueues[SCHED_sCommon.u8NumQueues].psQueue = psQueue;
+    SCHED_sCommon.asQueues[SCHED_sCommon.u8NumQueues].tTask = SCHED_BIT(u8Priority);
+    SCHED_sCommon.u8NumQueues++;
+
+    return TRUE;
+}
+
+/* Runs TIMER_vTask in slot u8Priority whenever a timer tick is pending. The
+ * tick timer stops in deep sleep, so the scheduler only enters it while no
+ * running timer was opened with TIMER_FLAG_PREVENT_SLEEP. */
+bool_t SCHED_bAddTimerTask ( uint8    u8Priority )
+{
+    if (!SCHED_bAddTask(u8Priority, SCHED_vTimerTask, NULL))
+    {
+        return FALSE;
+    }
+
+    SCHED_sCommon.tTimerTask = SCHED_BIT(u8Priority);
+
+    return TRUE;
+}
+
+/* Runs the work posted with DEFER_bPost in slot u8Priority, one item per call.
+ * Interrupt work is the most urgent, slot 0 suits it best. */
+bool_t SCHED_bAddDeferTask ( uint8    u8Priority )
+{
+    if (!SCHED_bAddTask(u8Priority, SCHED_vDeferTask, NULL))
+    {
+        return FALSE;
+    }
+
+    SCHED_sCommon.tDeferTask = SCHED_BIT(u8Priority);
+
+    return TRUE;
+}
+
+void SCHED_vAllowDeepSleep ( bool_t    bAllow )
+{
+    SCHED_sCommon.bDeepSleep = bAllow;
+}
+
+/* Makes the task in slot u8Priority ready; it runs once however many times it
+ * was posted before. May be called from an ISR. */
+void SCHED_vPost ( uint8    u8Priority )
+{
+    uint8 u8State;
+
+    if (u8Priority >= SCHED_MAX_TASKS)
+    {
+        return;
+    }
+
+    u8State = PORTABLE_u8EnterCritical();
+    SCHED_sCommon.tReady |= SCHED_BIT(u8Priority);
+    PORTABLE_vExitCritical(u8State);
+}
+
+/* Runs the highest priority ready task, returns FALSE when none is ready */
+bool_t SCHED_bRunOne ( void )
+{
+    SCHED_tsTask *psTask;
+    SCHED_tMask tReady;
+    SCHED_tMask tBit;
+    SCHED_tMask tAllowed;
+    uint8 u8State;
+    uint8 n;
+
+    tReady = SCHED_tPollSources();
+
+    u8State = PORTABLE_u8EnterCritical();
+    /* A post to an empty slot is dropped, it would never be consumed */
+    SCHED_sCommon.tReady &= SCHED_sCommon.tTasks;
+    tReady |= SCHED_sCommon.tReady;
+    tReady &= (SCHED_tMask)(SCHED_sCommon.tAllowed & SCHED_sCommon.tTasks);
+
+    /* The lowest bit set is the highest priority; its post is consumed before
+     * the task runs, so an event posted while it runs makes it ready again */
+    tBit = (SCHED_tMask)(tReady & (SCHED_tMask)(0U - tReady));
+    SCHED_sCommon.tReady &= (SCHED_tMask)~tBit;
+    PORTABLE_vExitCritical(u8State);
+
+    if (tBit == 0)
+    {
+        return FALSE;
+    }
+
+    for (n = 0; SCHED_BIT(n) != tBit; n++)
+    {
+    }
+
+    psTask = &SCHED_sCommon.asTasks[n];
+    tAllowed = SCHED_sCommon.tAllowed;
+    SCHED_sCommon.tAllowed = (SCHED_tMask)(tBit - 1);
+    psTask->pfTask(psTask->pvParam);
+    SCHED_sCommon.tAllowed = tAllowed;
+
+    return TRUE;
+}
+
+/* Idle hook for CO_vSetIdle: lets higher priority tasks run while the current
+ * one waits */
+void SCHED_vYield ( void )
+{
+    (void)SCHED_bRunOne();
+}
+
+/* Main loop of the application, never returns */
+void SCHED_vRun ( void )
+{
+    for (;;)
+    {
+        if (!SCHED_bRunOne())
+        {
+            SCHED_vIdle();
+        }
+    }
+}
+
+/****************************************************************************/
+/***        Local Functions                                               ***/
+/****************************************************************************/
+
+static void SCHED_vTimerTask ( void*    pvParam )
+{
+    (void)pvParam;
+
+    TIMER_vTask();
+}
+
+static void SCHED_vDeferTask ( void*    pvParam )
+{
+    (void)pvParam;
+
+    (void)DEFER_bRunOne();
+}
+
+/* Ready bits of the tasks whose queue, tick or deferred work is pending */
+static SCHED_tMask SCHED_tPollSources ( void )
+{
+    SCHED_tMask tReady = 0;
+    uint8 n;
+
+    if (SCHED_sCommon.tTimerTask != 0 && TIMER_bIsTickPending())
+    {
+        tReady |= SCHED_sCommon.tTimerTask;
+    }
+
+    if (SCHED_sCommon.tDeferTask != 0 && DEFER_bIsPending())
+    {
+        tReady |= SCHED_sCommon.tDeferTask;
+    }
+
+    for (n = 0; n < SCHED_sCommon.u8NumQueues; n++)
+    {
+        if (!QUEUE_bIsEmpty(SCHED_sCommon.asQueues[n].psQueue))
+        {
+            tReady |= SCHED_sCommon.asQueues[n].tTask;
+        }
+    }
+
+    return tReady;
+}
+
+/* Sleeps until a task is ready. Every interrupt wakes the core, but the wait
+ * only ends once an event is there. */
+static void SCHED_vIdle ( void )
+{
+    bool_t bTimer = (bool_t)(SCHED_sCommon.tTimerTask != 0);
+
+    PORTABLE_vDisableInterrupts();
+
+    while (((SCHED_sCommon.tReady | SCHED_tPollSources()) & SCHED_sCommon.tTasks) == 0)
+    {
+        /* Returns with interrupts disabled, after the waking ISR has run */
+        PWRM_vIdle(bTimer, SCHED_sCommon.bDeepSleep);
+    }
+
+    PORTABLE_vEnableInterrupts();
+}
+
+/****************************************************************************/
+/***        END OF FILE                                                   ***/
+/****************************************************************************/
@@ -0,0 +1,88 @@
+/****************************************************************************
+ *
+ * MODULE: Scheduler.h
+ *
+ * DESCRIPTION:
+ * Event driven run-to-completion scheduler for the main loop
+ *
+ *
+ ****************************************************************************
+ *
+ * This software is owned by NXP B.V. and/or its supplier and is protected
+ * under applicable copyright laws. All rights are reserved. We grant You,
+ * and any third parties, a license to use this software solely and
+ * exclusively on NXP products [NXP Microcontrollers such as JN5168, JN5179].
+ * You, and any third parties must reproduce the copyright and warranty notice
+ * and any other legend of ownership on each copy or partial copy of the
+ * software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Copyright NXP B.V. 2016. All rights reserved
+ *
+ ***************************************************************************/
+
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+#include "chip_selection.h"
+#include "Queue.h"
+
+/****************************************************************************/
+/***        Macro Definitions                                             ***/
+/****************************************************************************/
+
+/* Number of task slots, at most 16. The slot is the priority of its task,
+ * 0 runs first. */
+#ifndef SCHED_MAX_TASKS
+#define SCHED_MAX_TASKS         (8)
+#endif
+
+#ifndef SCHED_MAX_QUEUES
+#define SCHED_MAX_QUEUES        (4)
+#endif
+
+/****************************************************************************/
+/***        Type Definitions                                              ***/
+/****************************************************************************/
+
+#if (SCHED_MAX_TASKS <= 8)
+typedef uint8 SCHED_tMask;
+#elif (SCHED_MAX_TASKS <= 16)
+typedef uint16 SCHED_tMask;
+#else
+#error "SCHED_MAX_TASKS must be 16 or less"
+#endif
+
+typedef void (*SCHED_tpfTask)(void *pvParam);
+
+/****************************************************************************/
+/***        Exported Functions                                            ***/
+/****************************************************************************/
+
+void SCHED_vInit(void);
+bool_t SCHED_bAddTask(uint8 u8Priority, SCHED_tpfTask pfTask, void *pvParam);
+bool_t SCHED_bBindQueue(uint8 u8Priority, tsQueue *psQueue);
+bool_t SCHED_bAddTimerTask(uint8 u8Priority);
+bool_t SCHED_bAddDeferTask(uint8 u8Priority);
+void SCHED_vAllowDeepSleep(bool_t bAllow);
+void SCHED_vPost(uint8 u8Priority);
+bool_t SCHED_bRunOne(void);
+void SCHED_vYield(void);
+void SCHED_vRun(void);
+
+#endif /*SCHEDULER_H_*/
+
+/****************************************************************************/
+/***        END OF FILE                                                   ***/
+/****************************************************************************/
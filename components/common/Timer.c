@@ -40,6 +40,11 @@
 #include <string.h>
 //#include "dbg.h"
 #include "Timer.h"
+#include "port_mcu.h"
+#include "PowerManager.h"
+#ifdef TIMER_SUPPORT_PROFILING
+#include "dbg.h"
+#endif
 
 /****************************************************************************/
 /*          Macro Definitions                                               */
@@ -51,21 +56,81 @@
 #define TRACE_TIMER    FALSE
 #endif
 
+/* A running timer has expired once the ticks processed reached its deadline.
+ * Both are compared as ticks from u32Now, which every running deadline lies
+ * after, so a timer keeps the full 32 bit range TIMER_eStart takes; a signed
+ * difference would see a deadline 2^31 or more ahead as already passed. */
+#define TIMER_IS_DUE(u32Deadline, u32Now, u32Target) \
+    ((uint32)((u32Deadline) - (u32Now)) <= (uint32)((u32Target) - (u32Now)))
+
+/* End of the free list, a wheel slot or the sorted list */
+#define TIMER_NONE              ((TIMER_tIndex)~0U)
+
+#define TIMER_INDEX_MASK        (((TIMER_tHandle)1 << TIMER_INDEX_BITS) - 1)
+#define TIMER_HANDLE(tIndex)    ((TIMER_tHandle)(((TIMER_tHandle)TIMER_sCommon.psTimers[tIndex].tGeneration << TIMER_INDEX_BITS) | (tIndex)))
+
+#ifdef TIMER_SUPPORT_PROFILING
+#ifdef PORTABLE_SUPPORT_CYCLE_COUNTER
+#define TIMER_PROFILE_STAMP()   PORTABLE_u32CycleCounter()
+#define TIMER_PROFILE_TICK      PORTABLE_CYCLES_PER_TICK
+#define TIMER_PROFILE_UNIT      "cycles"
+#else
+#define TIMER_PROFILE_STAMP()   TIMER_u32NowUs()
+#define TIMER_PROFILE_TICK      (1000UL)
+#define TIMER_PROFILE_UNIT      "us"
+#endif
+#endif
+
+#if (TIMER_BACKEND == TIMER_BACKEND_WHEEL)
+#define TIMER_WHEEL_SLOTS       (1UL << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_MASK        (TIMER_WHEEL_SLOTS - 1)
+#define TIMER_WHEEL_RANGE       (1UL << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS))
+#endif
+
 /****************************************************************************/
 /***        Type Definitions                                                */
 /****************************************************************************/
 
 typedef struct
 {
-    volatile uint32   u8Ticks;
-    uint8            u8NumTimers;
+    volatile uint32   u32TickCount;     /* Free running, incremented by the tick ISR only; read
+                                           in a critical section, one access on STM8 is 16 bits */
+    uint32           u32TicksDone;      /* u32TickCount at the last TIMER_vTask */
+    uint32           u32Now;            /* Ticks processed since TIMER_eInit */
+    uint32           u32Target;         /* u32Now at the end of the TIMER_vTask pass in progress */
+#ifdef uint64
+    uint32           u32Epoch;          /* Wraps of u32Target, upper half of TIMER_tTime */
+#endif
+    TIMER_tIndex     tNumTimers;
+    TIMER_tIndex     tFreeHead;         /* First closed timer, linked through tNext */
     TIMER_tsTimer    *psTimers;
+#ifdef TIMER_SUPPORT_TICKLESS
+    bool_t           bStretched;        /* The time base runs one long period */
+    uint32           u32TicksAtSleep;   /* u32TickCount when the long period started */
+#endif
+#if (TIMER_BACKEND == TIMER_BACKEND_WHEEL)
+    TIMER_tIndex     atWheel[TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS];
+#elif (TIMER_BACKEND == TIMER_BACKEND_SORTED)
+    TIMER_tIndex     tHead;             /* Running timer with the earliest deadline */
+#endif
 } TIMER_tsCommon;
 
 /****************************************************************************/
 /*          Local Function Prototypes                                       */
 /****************************************************************************/
 
+static TIMER_tIndex TIMER_tLookup(TIMER_tHandle tTimer);
+static TIMER_tTime TIMER_tNow(uint16 *pu16Micros);
+static uint32 TIMER_u32Next(bool_t bSlack);
+static void TIMER_vInsert(TIMER_tIndex tTimerIndex);
+static void TIMER_vRemove(TIMER_tIndex tTimerIndex);
+static void TIMER_vAdvance(uint32 u32Ticks);
+static void TIMER_vExpire(TIMER_tIndex tTimerIndex);
+#ifdef TIMER_SUPPORT_PROFILING
+static void TIMER_vProfile(TIMER_tsTimer *psTimer, uint32 u32Exec, uint32 u32Late);
+static void TIMER_vProfileBin(uint16 *pu16Histogram, uint32 u32Value);
+#endif
+
 /****************************************************************************/
 /*          Exported Variables                                              */
 /****************************************************************************/
@@ -91,21 +156,46 @@ static TIMER_tsCommon TIMER_sCommon;
  * TIMER_teStatus
  *
  ****************************************************************************/
-TIMER_teStatus TIMER_eInit(TIMER_tsTimer *psTimers, uint8 u8NumTimers)
+TIMER_teStatus TIMER_eInit(TIMER_tsTimer *psTimers, uint16 u16NumTimers)
 {
 
+    TIMER_tIndex n;
+
 //    DBG_vPrintf(TRACE_TIMER, "ZT: Initialising: ");
 
-    if(psTimers == NULL || u8NumTimers == 0)
+    /* TIMER_NONE marks the end of a list, so it can not be a timer index */
+    if(psTimers == NULL || u16NumTimers == 0 || u16NumTimers >= TIMER_NONE)
     {
 //        DBG_vPrintf(TRACE_TIMER, "Failed\n");
         return E_TIMER_FAIL;
     }
 
-    TIMER_sCommon.u8Ticks = 0;
-    TIMER_sCommon.u8NumTimers = u8NumTimers;
+#if (TIMER_BACKEND == TIMER_BACKEND_WHEEL)
+    /* All ones bytes give TIMER_NONE whatever the index width */
+    memset(TIMER_sCommon.atWheel, 0xFF, sizeof(TIMER_sCommon.atWheel));
+#elif (TIMER_BACKEND == TIMER_BACKEND_SORTED)
+    TIMER_sCommon.tHead = TIMER_NONE;
+#endif
+
+    TIMER_sCommon.u32TickCount = 0;
+    TIMER_sCommon.u32TicksDone = 0;
+    TIMER_sCommon.u32Now = 0;
+    TIMER_sCommon.u32Target = 0;
+#ifdef uint64
+    TIMER_sCommon.u32Epoch = 0;
+#endif
+    TIMER_sCommon.tNumTimers = (TIMER_tIndex)u16NumTimers;
     TIMER_sCommon.psTimers = psTimers;
-    memset(psTimers, 0, sizeof(TIMER_tsTimer) * u8NumTimers);
+    memset(psTimers, 0, sizeof(TIMER_tsTimer) * u16NumTimers);
+
+    /* Every timer starts closed, in the free list in index order */
+    for(n = 0; n < TIMER_sCommon.tNumTimers; n++)
+    {
+        psTimers[n].tGeneration = 1;
+        psTimers[n].tNext = (TIMER_tIndex)(n + 1);
+    }
+    psTimers[TIMER_sCommon.tNumTimers - 1].tNext = TIMER_NONE;
+    TIMER_sCommon.tFreeHead = 0;
 
 //    DBG_vPrintf(TRACE_TIMER, "Success\n");
 
@@ -129,10 +219,9 @@ void ISR_vTickTimer(void)
 {
     /* TODO: clear interrupt time base */
 
-    if(TIMER_sCommon.u8Ticks < 0xff)
-    {
-        TIMER_sCommon.u8Ticks++;
-    }
+    /* Never saturates: TIMER_vTask takes the difference to the ticks it has
+     * done, which 32 bits keep for 49 days at 1 ms however late it runs */
+    TIMER_sCommon.u32TickCount++;
 }
 
 /****************************************************************************
@@ -140,7 +229,11 @@ void ISR_vTickTimer(void)
  * NAME: TIMER_vSleep
  *
  * DESCRIPTION:
- *
+ * With TIMER_SUPPORT_TICKLESS, stretches the time base so that its next
+ * interrupt comes at the end of the earliest timer window (deadline plus
+ * slack, see TIMER_eSetSlack) instead of the next tick.
+ * Must be called with interrupts disabled right before the idle instruction
+ * and paired with TIMER_vWake once the core runs again.
  *
  * RETURNS:
  * void
@@ -148,8 +241,21 @@ void ISR_vTickTimer(void)
  ****************************************************************************/
 void TIMER_vSleep(void)
 {
-    /* TODO: disable time base */
+#ifdef TIMER_SUPPORT_TICKLESS
+
+    uint32 u32Next = TIMER_u32NextWakeup();
+
+    TIMER_sCommon.bStretched = FALSE;
+
+    /* Nothing to gain when a timer is due within the next tick */
+    if(u32Next < 2)
+    {
+        return;
+    }
 
+    TIMER_sCommon.u32TicksAtSleep = TIMER_sCommon.u32TickCount;
+    TIMER_sCommon.bStretched = PORTABLE_bTimebaseStretch(u32Next);
+#endif
 }
 
 
@@ -158,7 +264,8 @@ void TIMER_vSleep(void)
  * NAME: TIMER_vWake
  *
  * DESCRIPTION:
- *
+ * Ends a stretched time base period, adds the ticks that went by to the
+ * pending ticks and resumes the normal tick in phase. Interrupts disabled.
  *
  * RETURNS:
  * void
@@ -166,8 +273,17 @@ void TIMER_vSleep(void)
  ****************************************************************************/
 void TIMER_vWake(void)
 {
-    /* TODO: enable time base and restart */
-    
+#ifdef TIMER_SUPPORT_TICKLESS
+
+    if(!TIMER_sCommon.bStretched)
+    {
+        return;
+    }
+    TIMER_sCommon.bStretched = FALSE;
+
+    /* Any tick counted since TIMER_vSleep can only be the end of the long period */
+    TIMER_sCommon.u32TickCount += PORTABLE_u32TimebaseRestore((bool_t)(TIMER_sCommon.u32TickCount != TIMER_sCommon.u32TicksAtSleep));
+#endif
 }
 
 
@@ -176,7 +292,8 @@ void TIMER_vWake(void)
  * NAME: TIMER_vTask
  *
  * DESCRIPTION:
- *
+ * Processes every tick raised since the last call in one pass, firing the
+ * timers that became due in deadline order
  *
  * RETURNS:
  * void
@@ -185,113 +302,204 @@ void TIMER_vWake(void)
 void TIMER_vTask(void)
 {
 
-    int n;
-    TIMER_tsTimer *psTimer;
+    uint32 u32Ticks;
+    uint8 u8State;
+
+    /* TIMER_tNow, also called from ISRs, reads the pass fields together */
+    u8State = PORTABLE_u8EnterCritical();
+    u32Ticks = TIMER_sCommon.u32TickCount - TIMER_sCommon.u32TicksDone;
 
     /* If no ticks to process, exit */
-    if(TIMER_sCommon.u8Ticks == 0)
+    if(u32Ticks == 0)
     {
+        PORTABLE_vExitCritical(u8State);
         return;
     }
 
-    /* Decrement the tick counter */
-    TIMER_sCommon.u8Ticks--;
+    TIMER_sCommon.u32TicksDone = TIMER_sCommon.u32TickCount;
+    TIMER_sCommon.u32Target = TIMER_sCommon.u32Now + u32Ticks;
+#ifdef uint64
+    if(TIMER_sCommon.u32Target < TIMER_sCommon.u32Now)
+    {
+        TIMER_sCommon.u32Epoch++;
+    }
+#endif
+    PORTABLE_vExitCritical(u8State);
 
-//    DBG_vPrintf(TRACE_TIMER, "ZT: Tick\n");
+//    DBG_vPrintf(TRACE_TIMER, "ZT: %d Ticks\n", u32Ticks);
 
-    /* Process all of the timers */
-    for(n = 0; n < TIMER_sCommon.u8NumTimers; n++)
-    {
+    /* Move time on and expire the timers that are due */
+    TIMER_vAdvance(u32Ticks);
 
-        psTimer = &TIMER_sCommon.psTimers[n];
+}
 
-        /* If this timer is not opened and running, skip it */
-        if(psTimer->eState != E_TIMER_STATE_RUNNING)
-        {
-            continue;
-        }
 
-//        DBG_vPrintf(TRACE_TIMER, "ZT: Processing timer %d - time %d\n", n, psTimer->u32Time);
+/****************************************************************************
+ *
+ * NAME: TIMER_bIsTickPending
+ *
+ * DESCRIPTION:
+ * Tells whether TIMER_vTask has ticks left to process
+ *
+ * RETURNS:
+ * bool_t
+ *
+ ****************************************************************************/
+bool_t TIMER_bIsTickPending(void)
+{
+    uint8 u8State = PORTABLE_u8EnterCritical();
+    bool_t bPending = (bool_t)(TIMER_sCommon.u32TickCount != TIMER_sCommon.u32TicksDone);
 
-        /* Decrement the time */
-        psTimer->u32Time--;
+    PORTABLE_vExitCritical(u8State);
+    return bPending;
+}
 
-        /* If the timer has not expired, move on to the next one */
-        if(psTimer->u32Time > 0)
-        {
-            continue;
-        }
 
-        /* Mark the timer as expired. We must do this _before_ calling the callback
-         * in case the user restarts the timer in the callback */
-        psTimer->eState = E_TIMER_STATE_EXPIRED;
+/****************************************************************************
+ *
+ * NAME: TIMER_u32NextExpiry
+ *
+ * DESCRIPTION:
+ * Number of ticks until the next running timer expires, counting the ticks
+ * the ISR has already raised but TIMER_vTask has not processed yet. 0 means
+ * TIMER_vTask has work now; TIMER_NO_EXPIRY that no timer is running.
+ *
+ * RETURNS:
+ * uint32
+ *
+ ****************************************************************************/
+uint32 TIMER_u32NextExpiry(void)
+{
+    return TIMER_u32Next(FALSE);
+}
 
-//        DBG_vPrintf(TRACE_TIMER, "ZT: Timer %d expired\n", n);
 
-        /* If this timer should prevent sleeping while running, decrement the activity count */
-        if(psTimer->u8Flags & TIMER_FLAG_PREVENT_SLEEP)
-        {
-            /*TODO: decrement the activity count*/
-            
-        }
+/****************************************************************************
+ *
+ * NAME: TIMER_u32NextWakeup
+ *
+ * DESCRIPTION:
+ * Like TIMER_u32NextExpiry but allows for the slack of each timer: ticks until
+ * the earliest window (deadline plus slack) ends. Every timer whose deadline
+ * falls before then expires in the same TIMER_vTask call.
+ *
+ * RETURNS:
+ * uint32
+ *
+ ****************************************************************************/
+uint32 TIMER_u32NextWakeup(void)
+{
+    return TIMER_u32Next(TRUE);
+}
 
-        /* If the timer has  a valid callback, call it */
-        if(psTimer->pfCallback != NULL)
-        {
-            psTimer->pfCallback(psTimer->pvParameters);
-        }
 
-    }
+/****************************************************************************
+ *
+ * NAME: TIMER_u32NowMs / TIMER_u64NowMs
+ *
+ * DESCRIPTION:
+ * Ticks (ms) since TIMER_eInit, including the ticks TIMER_vTask has not
+ * processed yet. The 32 bit value wraps after 49.7 days.
+ *
+ * RETURNS:
+ * uint32 / uint64
+ *
+ ****************************************************************************/
+uint32 TIMER_u32NowMs(void)
+{
+    return (uint32)TIMER_tNow(NULL);
+}
 
+#ifdef uint64
+uint64 TIMER_u64NowMs(void)
+{
+    return TIMER_tNow(NULL);
 }
+#endif
 
 
 /****************************************************************************
  *
- * NAME: TIMER_eOpen
+ * NAME: TIMER_u32NowUs / TIMER_u64NowUs
  *
  * DESCRIPTION:
+ * Microseconds since TIMER_eInit, the tick count refined with the time base
+ * counter. The 32 bit value wraps after 71 minutes. While the time base is
+ * stretched for tickless idle it only has the resolution of the tick.
+ *
+ * RETURNS:
+ * uint32 / uint64
+ *
+ ****************************************************************************/
+uint32 TIMER_u32NowUs(void)
+{
+    uint16 u16Micros;
+    uint32 u32Ms = (uint32)TIMER_tNow(&u16Micros);
+
+    return (u32Ms * 1000UL) + u16Micros;
+}
+
+#ifdef uint64
+uint64 TIMER_u64NowUs(void)
+{
+    uint16 u16Micros;
+    uint64 u64Ms = TIMER_tNow(&u16Micros);
+
+    return (u64Ms * 1000) + u16Micros;
+}
+#endif
+
+
+/****************************************************************************
  *
+ * NAME: TIMER_eOpen
+ *
+ * DESCRIPTION:
+ * Takes the first timer of the free list and returns its handle
  *
  * RETURNS:
  * TIMER_teStatus
  *
  ****************************************************************************/
-TIMER_teStatus TIMER_eOpen(uint8 *pu8TimerIndex, TIMER_tpfCallback pfCallback, void *pvParams, uint8 u8Flags)
+TIMER_teStatus TIMER_eOpen(TIMER_tHandle *ptTimer, TIMER_tpfCallback pfCallback, void *pvParams, uint8 u8Flags)
 {
 
-    int n;
+    TIMER_tIndex tTimerIndex = TIMER_sCommon.tFreeHead;
     TIMER_tsTimer *psTimer;
 
 //    DBG_vPrintf(TRACE_TIMER, "ZT: Open: ");
 
-    /* Find a unused timer */
-    for(n = 0; n < TIMER_sCommon.u8NumTimers; n++)
+    /* No unused timer left */
+    if(tTimerIndex == TIMER_NONE)
     {
+//        DBG_vPrintf(TRACE_TIMER, "Failed\n");
+        return E_TIMER_FAIL;
+    }
 
-        psTimer = &TIMER_sCommon.psTimers[n];
-
-        if(psTimer->eState == E_TIMER_STATE_CLOSED)
-        {
-            psTimer->u8Flags             = u8Flags;
-            psTimer->pvParameters        = pvParams;
-            psTimer->pfCallback          = pfCallback;
-            psTimer->u32Time             = 0;
-            psTimer->eState              = E_TIMER_STATE_STOPPED;
-
-            /* Return the index of the timer */
-            *pu8TimerIndex = n;
-
-//            DBG_vPrintf(TRACE_TIMER, "Success (%d)\n", n);
-
-            return E_TIMER_OK;
+    psTimer = &TIMER_sCommon.psTimers[tTimerIndex];
+    TIMER_sCommon.tFreeHead = psTimer->tNext;
+
+    psTimer->u8Flags             = u8Flags;
+    psTimer->pvParameters        = pvParams;
+    psTimer->pfCallback          = pfCallback;
+    psTimer->u32Time             = 0;
+    psTimer->u16Slack            = 0;
+    psTimer->eState              = E_TIMER_STATE_STOPPED;
+#ifdef TIMER_SUPPORT_PROFILING
+    psTimer->u32Runs             = 0;
+    psTimer->u32Overruns         = 0;
+    psTimer->u32ExecMax          = 0;
+    psTimer->u32LateMax          = 0;
+    memset(psTimer->au16ExecHistogram, 0, sizeof(psTimer->au16ExecHistogram));
+    memset(psTimer->au16LateHistogram, 0, sizeof(psTimer->au16LateHistogram));
+#endif
 
-        }
-    }
+    /* Return the handle of the timer */
+    *ptTimer = TIMER_HANDLE(tTimerIndex);
 
-//    DBG_vPrintf(TRACE_TIMER, "Failed\n");
+//    DBG_vPrintf(TRACE_TIMER, "Success (%d)\n", tTimerIndex);
 
-    return E_TIMER_FAIL;
+    return E_TIMER_OK;
 
 }
 
@@ -301,31 +509,49 @@ TIMER_teStatus TIMER_eOpen(uint8 *pu8TimerIndex, TIMER_tpfCallback pfCallback, v
  * NAME: TIMER_eClose
  *
  * DESCRIPTION:
- *
+ * Returns the timer to the free list; the handle and its copies become stale
  *
  * RETURNS:
  * TIMER_teStatus
  *
  ****************************************************************************/
-TIMER_teStatus TIMER_eClose(uint8 u8TimerIndex)
+TIMER_teStatus TIMER_eClose(TIMER_tHandle tTimer)
 {
 
-//    DBG_vPrintf(TRACE_TIMER, "ZT: Close (%d): ", u8TimerIndex);
+    TIMER_tIndex tTimerIndex = TIMER_tLookup(tTimer);
+    TIMER_tsTimer *psTimer;
+
+//    DBG_vPrintf(TRACE_TIMER, "ZT: Close (%d): ", tTimerIndex);
 
-    if(u8TimerIndex > TIMER_sCommon.u8NumTimers)
+    if(tTimerIndex == TIMER_NONE)
     {
 //        DBG_vPrintf(TRACE_TIMER, "Failed\n");
         return E_TIMER_FAIL;
     }
 
+    psTimer = &TIMER_sCommon.psTimers[tTimerIndex];
+
     /* If the timer is currently running, decrease power manager activity count */
-    if(TIMER_sCommon.psTimers[u8TimerIndex].eState == E_TIMER_STATE_RUNNING)
+    if(psTimer->eState == E_TIMER_STATE_RUNNING)
+    {
+        if(psTimer->u8Flags & TIMER_FLAG_PREVENT_SLEEP)
+        {
+            PWRM_vFinishActivity(E_PWRM_ACTIVITY_TIMER);
+        }
+
+        TIMER_vRemove(tTimerIndex);
+    }
+
+    psTimer->eState = E_TIMER_STATE_CLOSED;
+
+    /* Generation 0 is skipped so that TIMER_INVALID_HANDLE stays invalid */
+    if(++psTimer->tGeneration == 0)
     {
-        /*TODO: decrease power manager activity count*/
-        
+        psTimer->tGeneration = 1;
     }
 
-    TIMER_sCommon.psTimers[u8TimerIndex].eState = E_TIMER_STATE_CLOSED;
+    psTimer->tNext = TIMER_sCommon.tFreeHead;
+    TIMER_sCommon.tFreeHead = tTimerIndex;
 
 //    DBG_vPrintf(TRACE_TIMER, "Success\n");
 
@@ -345,28 +571,41 @@ TIMER_teStatus TIMER_eClose(uint8 u8TimerIndex)
  * TIMER_teStatus
  *
  ****************************************************************************/
-TIMER_teStatus TIMER_eStart(uint8 u8TimerIndex, uint32 u32Time)
+TIMER_teStatus TIMER_eStart(TIMER_tHandle tTimer, uint32 u32Time)
 {
 
-//    DBG_vPrintf(TRACE_TIMER, "ZT: Start (%d): ", u8TimerIndex);
+    TIMER_tIndex tTimerIndex = TIMER_tLookup(tTimer);
+    TIMER_tsTimer *psTimer;
+
+//    DBG_vPrintf(TRACE_TIMER, "ZT: Start (%d): ", tTimerIndex);
 
-    /* Check timer index is valid and the timer has previously been opened */
-    if(u8TimerIndex > TIMER_sCommon.u8NumTimers || TIMER_sCommon.psTimers[u8TimerIndex].eState == E_TIMER_STATE_CLOSED || u32Time == 0)
+    /* Check the handle is current and the timer has previously been opened */
+    if(tTimerIndex == TIMER_NONE || u32Time == 0)
     {
 //        DBG_vPrintf(TRACE_TIMER, "Failed\n");
         return E_TIMER_FAIL;
     }
 
+    psTimer = &TIMER_sCommon.psTimers[tTimerIndex];
+
     /* If this timer should prevent sleeping while running and the timer is not currently running, increase power manager activity count */
-    if((TIMER_sCommon.psTimers[u8TimerIndex].u8Flags & TIMER_FLAG_PREVENT_SLEEP) && (TIMER_sCommon.psTimers[u8TimerIndex].eState != E_TIMER_STATE_RUNNING))
+    if((psTimer->u8Flags & TIMER_FLAG_PREVENT_SLEEP) && (psTimer->eState != E_TIMER_STATE_RUNNING))
     {
-        /*TODO: increase power manager activity count */
-        
+        PWRM_vStartActivity(E_PWRM_ACTIVITY_TIMER);
+    }
+
+    /* A restart moves the timer to its new deadline */
+    if(psTimer->eState == E_TIMER_STATE_RUNNING)
+    {
+        TIMER_vRemove(tTimerIndex);
     }
 
     /* Load the timer and start it */
-    TIMER_sCommon.psTimers[u8TimerIndex].u32Time = u32Time;
-    TIMER_sCommon.psTimers[u8TimerIndex].eState = E_TIMER_STATE_RUNNING;
+    psTimer->u32Time = TIMER_sCommon.u32Now + u32Time;
+    psTimer->u32Period = u32Time;
+    psTimer->u16Missed = 0;
+    psTimer->eState = E_TIMER_STATE_RUNNING;
+    TIMER_vInsert(tTimerIndex);
 
 //    DBG_vPrintf(TRACE_TIMER, "Success\n");
 
@@ -375,6 +614,81 @@ TIMER_teStatus TIMER_eStart(uint8 u8TimerIndex, uint32 u32Time)
 }
 
 
+/****************************************************************************
+ *
+ * NAME: TIMER_eStartAt
+ *
+ * DESCRIPTION:
+ * Starts a timer that expires when TIMER_u64NowMs reaches tDeadline. A
+ * deadline already passed expires on the next tick processed. A periodic
+ * timer takes the time to its first deadline as its period.
+ *
+ * RETURNS:
+ * TIMER_teStatus
+ *
+ ****************************************************************************/
+TIMER_teStatus TIMER_eStartAt(TIMER_tHandle tTimer, TIMER_tTime tDeadline)
+{
+
+    TIMER_tTime tNow;
+    bool_t bPassed;
+
+    /* Deadlines count from the ticks processed, which in a callback is the
+     * callback's own deadline rather than the latest tick */
+#ifdef uint64
+    tNow = ((uint64)TIMER_sCommon.u32Epoch << 32) | TIMER_sCommon.u32Target;
+#else
+    tNow = TIMER_sCommon.u32Target;
+#endif
+    tNow -= (TIMER_sCommon.u32Target - TIMER_sCommon.u32Now);
+
+#ifdef uint64
+    /* Running timers hold 32 bit deadlines */
+    if(tDeadline > (tNow + 0xFFFFFFFFUL))
+    {
+        return E_TIMER_FAIL;
+    }
+    bPassed = (tDeadline <= tNow);
+#else
+    /* The 32 bit time wraps, a deadline is taken within 2^31 ticks of now */
+    bPassed = ((int32)(tDeadline - tNow) <= 0);
+#endif
+
+    return TIMER_eStart(tTimer, bPassed ? 1 : (uint32)(tDeadline - tNow));
+
+}
+
+
+/****************************************************************************
+ *
+ * NAME: TIMER_eSetSlack
+ *
+ * DESCRIPTION:
+ * Lets the timer fire up to u16Slack ticks after its deadline, so that a
+ * tickless sleep can end on one wakeup for several timers. Kept across
+ * starts; 0 (the default after TIMER_eOpen) fires on the deadline.
+ *
+ * RETURNS:
+ * TIMER_teStatus
+ *
+ ****************************************************************************/
+TIMER_teStatus TIMER_eSetSlack(TIMER_tHandle tTimer, uint16 u16Slack)
+{
+
+    TIMER_tIndex tTimerIndex = TIMER_tLookup(tTimer);
+
+    if(tTimerIndex == TIMER_NONE)
+    {
+        return E_TIMER_FAIL;
+    }
+
+    TIMER_sCommon.psTimers[tTimerIndex].u16Slack = u16Slack;
+
+    return E_TIMER_OK;
+
+}
+
+
 /****************************************************************************
  *
  * NAME: TIMER_eStop
@@ -386,27 +700,35 @@ TIMER_teStatus TIMER_eStart(uint8 u8TimerIndex, uint32 u32Time)
  * TIMER_teStatus
  *
  ****************************************************************************/
-TIMER_teStatus TIMER_eStop(uint8 u8TimerIndex)
+TIMER_teStatus TIMER_eStop(TIMER_tHandle tTimer)
 {
 
-//    DBG_vPrintf(TRACE_TIMER, "ZT: Stop (%d): ", u8TimerIndex);
+    TIMER_tIndex tTimerIndex = TIMER_tLookup(tTimer);
+    TIMER_tsTimer *psTimer;
+
+//    DBG_vPrintf(TRACE_TIMER, "ZT: Stop (%d): ", tTimerIndex);
 
-    /* Check timer index is valid and the timer has previously been opened */
-    if(u8TimerIndex > TIMER_sCommon.u8NumTimers || TIMER_sCommon.psTimers[u8TimerIndex].eState == E_TIMER_STATE_CLOSED)
+    /* Check the handle is current and the timer has previously been opened */
+    if(tTimerIndex == TIMER_NONE)
     {
 //        DBG_vPrintf(TRACE_TIMER, "Failed\n");
         return E_TIMER_FAIL;
     }
 
+    psTimer = &TIMER_sCommon.psTimers[tTimerIndex];
+
     /* If this timer should prevent sleeping while running and the timer is currently running, decrease power manager activity count */
-    if((TIMER_sCommon.psTimers[u8TimerIndex].u8Flags & TIMER_FLAG_PREVENT_SLEEP) && (TIMER_sCommon.psTimers[u8TimerIndex].eState == E_TIMER_STATE_RUNNING))
+    if((psTimer->u8Flags & TIMER_FLAG_PREVENT_SLEEP) && (psTimer->eState == E_TIMER_STATE_RUNNING))
     {
-        /*TODO: decrease power manager activity count*/
-        
+        PWRM_vFinishActivity(E_PWRM_ACTIVITY_TIMER);
     }
 
     /* Stop the timer */
-    TIMER_sCommon.psTimers[u8TimerIndex].eState = E_TIMER_STATE_STOPPED;
+    if(psTimer->eState == E_TIMER_STATE_RUNNING)
+    {
+        TIMER_vRemove(tTimerIndex);
+    }
+    psTimer->eState = E_TIMER_STATE_STOPPED;
 
 //    DBG_vPrintf(TRACE_TIMER, "Success\n");
 
@@ -420,21 +742,810 @@ TIMER_teStatus TIMER_eStop(uint8 u8TimerIndex)
  * NAME: TIMER_eGetState
  *
  * DESCRIPTION:
- *
+ * A stale handle reads as a closed timer
  *
  * RETURNS:
  * TIMER_teState
  *
  ****************************************************************************/
-TIMER_teState TIMER_eGetState(uint8 u8TimerIndex)
+TIMER_teState TIMER_eGetState(TIMER_tHandle tTimer)
 {
-     return TIMER_sCommon.psTimers[u8TimerIndex].eState;
+     TIMER_tIndex tTimerIndex = TIMER_tLookup(tTimer);
+
+     if(tTimerIndex == TIMER_NONE)
+     {
+         return E_TIMER_STATE_CLOSED;
+     }
+
+     return TIMER_sCommon.psTimers[tTimerIndex].eState;
 }
 
 
-/****************************************************************************/
-/***        Local Functions                                                 */
-/****************************************************************************/
+/****************************************************************************
+ *
+ * NAME: TIMER_u16GetMissed
+ *
+ * DESCRIPTION:
+ * Number of periods a TIMER_FLAG_PERIODIC timer skipped because TIMER_vTask
+ * ran more than a period late, since it was last started
+ *
+ * RETURNS:
+ * uint16
+ *
+ ****************************************************************************/
+uint16 TIMER_u16GetMissed(TIMER_tHandle tTimer)
+{
+     TIMER_tIndex tTimerIndex = TIMER_tLookup(tTimer);
+
+     if(tTimerIndex == TIMER_NONE)
+     {
+         return 0;
+     }
+
+     return TIMER_sCommon.psTimers[tTimerIndex].u16Missed;
+}
+
+
+#ifdef TIMER_SUPPORT_PROFILING
+/****************************************************************************
+ *
+ * NAME: TIMER_vResetProfile
+ *
+ * DESCRIPTION:
+ * Clears the callback profile of every timer
+ *
+ * RETURNS:
+ * void
+ *
+ ****************************************************************************/
+void TIMER_vResetProfile(void)
+{
+
+    TIMER_tsTimer *psTimer;
+    int n;
+
+    for(n = 0; n < TIMER_sCommon.tNumTimers; n++)
+    {
+        psTimer = &TIMER_sCommon.psTimers[n];
+        psTimer->u32Runs = 0;
+        psTimer->u32Overruns = 0;
+        psTimer->u32ExecMax = 0;
+        psTimer->u32LateMax = 0;
+        memset(psTimer->au16ExecHistogram, 0, sizeof(psTimer->au16ExecHistogram));
+        memset(psTimer->au16LateHistogram, 0, sizeof(psTimer->au16LateHistogram));
+    }
+
+}
+
+
+/****************************************************************************
+ *
+ * NAME: TIMER_vDumpProfile
+ *
+ * DESCRIPTION:
+ * Prints the callback profile of every open timer that ran, one line each
+ *
+ * RETURNS:
+ * void
+ *
+ ****************************************************************************/
+void TIMER_vDumpProfile(void)
+{
+
+    TIMER_tsTimer *psTimer;
+    int n;
+    int i;
+
+    for(n = 0; n < TIMER_sCommon.tNumTimers; n++)
+    {
+        psTimer = &TIMER_sCommon.psTimers[n];
+        if(psTimer->eState == E_TIMER_STATE_CLOSED || psTimer->u32Runs == 0)
+        {
+            continue;
+        }
+
+        DBG_vPrintf(TRUE, "TIMER: %08lx Runs=%lu Overruns=%lu ExecMax=%lu" TIMER_PROFILE_UNIT " LateMax=%luus Exec=",
+                    (unsigned long)TIMER_HANDLE(n),
+                    (unsigned long)psTimer->u32Runs,
+                    (unsigned long)psTimer->u32Overruns,
+                    (unsigned long)psTimer->u32ExecMax,
+                    (unsigned long)psTimer->u32LateMax);
+
+        for(i = 0; i < TIMER_PROFILE_BINS; i++)
+        {
+            DBG_vPrintf(TRUE, " %u", psTimer->au16ExecHistogram[i]);
+        }
+        DBG_vPrintf(TRUE, " Late=");
+        for(i = 0; i < TIMER_PROFILE_BINS; i++)
+        {
+            DBG_vPrintf(TRUE, " %u", psTimer->au16LateHistogram[i]);
+        }
+        DBG_vPrintf(TRUE, "\n");
+    }
+
+}
+#endif
+
+
+/****************************************************************************/
+/***        Local Functions                                                 */
+/****************************************************************************/
+
+/****************************************************************************
+ *
+ * NAME: TIMER_tLookup
+ *
+ * DESCRIPTION:
+ * Index of the open timer a handle refers to, checked against the number of
+ * timers and the generation of the slot
+ *
+ * RETURNS:
+ * TIMER_tIndex, TIMER_NONE for a stale or invalid handle
+ *
+ ****************************************************************************/
+static TIMER_tIndex TIMER_tLookup(TIMER_tHandle tTimer)
+{
+
+    TIMER_tIndex tTimerIndex = (TIMER_tIndex)(tTimer & TIMER_INDEX_MASK);
+
+    if(tTimerIndex >= TIMER_sCommon.tNumTimers ||
+       TIMER_sCommon.psTimers[tTimerIndex].tGeneration != (TIMER_tIndex)(tTimer >> TIMER_INDEX_BITS) ||
+       TIMER_sCommon.psTimers[tTimerIndex].eState == E_TIMER_STATE_CLOSED)
+    {
+        return TIMER_NONE;
+    }
+
+    return tTimerIndex;
+
+}
+
+
+/****************************************************************************
+ *
+ * NAME: TIMER_u32Next
+ *
+ * DESCRIPTION:
+ * Ticks from now to the earliest deadline, or with bSlack to the earliest end
+ * of a timer window (deadline plus slack)
+ *
+ * RETURNS:
+ * uint32, TIMER_NO_EXPIRY when no timer is running
+ *
+ ****************************************************************************/
+static uint32 TIMER_u32Next(bool_t bSlack)
+{
+
+    uint32 u32Next = TIMER_NO_EXPIRY;
+    uint32 u32Pending;
+    uint32 u32Left;
+    uint8 u8State;
+    TIMER_tsTimer *psTimer;
+#if (TIMER_BACKEND == TIMER_BACKEND_SORTED)
+    TIMER_tIndex tTimerIndex;
+
+    /* In deadline order: once a deadline is beyond the earliest window end, so
+     * is every window after it */
+    for(tTimerIndex = TIMER_sCommon.tHead; tTimerIndex != TIMER_NONE; tTimerIndex = psTimer->tNext)
+    {
+        psTimer = &TIMER_sCommon.psTimers[tTimerIndex];
+        u32Left = psTimer->u32Time - TIMER_sCommon.u32Now;
+        if(u32Left >= u32Next)
+        {
+            break;
+        }
+#else
+    int n;
+
+    /* Only called before sleeping, a scan of the array is cheap enough there */
+    for(n = 0; n < TIMER_sCommon.tNumTimers; n++)
+    {
+        psTimer = &TIMER_sCommon.psTimers[n];
+        if(psTimer->eState != E_TIMER_STATE_RUNNING)
+        {
+            continue;
+        }
+        u32Left = psTimer->u32Time - TIMER_sCommon.u32Now;
+#endif
+
+        if(bSlack)
+        {
+            /* Saturate below TIMER_NO_EXPIRY, which means no timer */
+            u32Left += psTimer->u16Slack;
+            if(u32Left < psTimer->u16Slack || u32Left == TIMER_NO_EXPIRY)
+            {
+                u32Left = TIMER_NO_EXPIRY - 1;
+            }
+        }
+
+        if(u32Left < u32Next)
+        {
+            u32Next = u32Left;
+        }
+    }
+
+    if(u32Next == TIMER_NO_EXPIRY)
+    {
+        return TIMER_NO_EXPIRY;
+    }
+
+    u8State = PORTABLE_u8EnterCritical();
+    u32Pending = TIMER_sCommon.u32TickCount - TIMER_sCommon.u32TicksDone;
+    PORTABLE_vExitCritical(u8State);
+
+    return (u32Pending >= u32Next) ? 0 : (u32Next - u32Pending);
+
+}
+
+
+/****************************************************************************
+ *
+ * NAME: TIMER_tNow
+ *
+ * DESCRIPTION:
+ * Absolute time in ticks, with the microseconds gone in the current tick
+ * when pu16Micros is not NULL
+ *
+ * RETURNS:
+ * TIMER_tTime
+ *
+ ****************************************************************************/
+static TIMER_tTime TIMER_tNow(uint16 *pu16Micros)
+{
+
+    uint32 u32Count;
+    uint32 u32Done;
+    TIMER_tTime tNow;
+    uint8 u8State;
+    bool_t bTicked;
+
+    /* The micros must belong to the tick count, read again if a tick came in */
+    do
+    {
+        /* A consistent pass: TIMER_vTask may be interrupted between its writes */
+        u8State = PORTABLE_u8EnterCritical();
+        u32Count = TIMER_sCommon.u32TickCount;
+        u32Done = TIMER_sCommon.u32TicksDone;
+#ifdef uint64
+        tNow = ((uint64)TIMER_sCommon.u32Epoch << 32) | TIMER_sCommon.u32Target;
+#else
+        tNow = TIMER_sCommon.u32Target;
+#endif
+        PORTABLE_vExitCritical(u8State);
+
+        if(pu16Micros != NULL)
+        {
+            *pu16Micros = 0;
+#ifdef TIMER_SUPPORT_TICKLESS
+            if(!TIMER_sCommon.bStretched)
+#endif
+            {
+                *pu16Micros = PORTABLE_u16TimebaseMicros();
+            }
+        }
+
+        u8State = PORTABLE_u8EnterCritical();
+        bTicked = (bool_t)(u32Count != TIMER_sCommon.u32TickCount);
+        PORTABLE_vExitCritical(u8State);
+    } while(bTicked);
+
+    /* The end of the pass in progress plus the ticks not processed yet */
+    return tNow + (u32Count - u32Done);
+
+}
+
+
+/****************************************************************************
+ *
+ * NAME: TIMER_vExpire
+ *
+ * DESCRIPTION:
+ * Marks a due timer as expired and calls its callback
+ *
+ * RETURNS:
+ * void
+ *
+ ****************************************************************************/
+static void TIMER_vExpire(TIMER_tIndex tTimerIndex)
+{
+
+    TIMER_tsTimer *psTimer = &TIMER_sCommon.psTimers[tTimerIndex];
+    uint32 u32Skip;
+#ifdef TIMER_SUPPORT_PROFILING
+    TIMER_tIndex tGeneration = psTimer->tGeneration;
+    uint32 u32Late;
+    uint32 u32Start;
+#endif
+
+    /* Mark the timer as expired. We must do this _before_ calling the callback
+     * in case the user restarts the timer in the callback */
+    psTimer->eState = E_TIMER_STATE_EXPIRED;
+
+    /* If this timer should prevent sleeping while running, decrement the activity count */
+    if(psTimer->u8Flags & TIMER_FLAG_PREVENT_SLEEP)
+    {
+        PWRM_vFinishActivity(E_PWRM_ACTIVITY_TIMER);
+    }
+
+    /* If the timer has  a valid callback, call it */
+    if(psTimer->pfCallback != NULL)
+    {
+#ifdef TIMER_SUPPORT_PROFILING
+        /* The deadline in us wraps along with TIMER_u32NowUs */
+        u32Late = TIMER_u32NowUs() - (psTimer->u32Time * 1000UL);
+        u32Start = TIMER_PROFILE_STAMP();
+        psTimer->pfCallback(psTimer->pvParameters);
+
+        /* Not if the callback closed the timer, the slot may be another timer by now */
+        if(psTimer->tGeneration == tGeneration)
+        {
+            TIMER_vProfile(psTimer, TIMER_PROFILE_STAMP() - u32Start, u32Late);
+        }
+#else
+        psTimer->pfCallback(psTimer->pvParameters);
+#endif
+    }
+
+    /* Reload a periodic timer unless the callback stopped, closed or restarted it */
+    if((psTimer->u8Flags & TIMER_FLAG_PERIODIC) && (psTimer->eState == E_TIMER_STATE_EXPIRED))
+    {
+
+        /* The next deadline follows the one just expired, so the callback latency
+         * does not add up; deadlines already passed by the end of this pass are
+         * skipped rather than fired back to back */
+        u32Skip = (TIMER_sCommon.u32Target - psTimer->u32Time) / psTimer->u32Period;
+        psTimer->u32Time += (u32Skip + 1) * psTimer->u32Period;
+
+        if(u32Skip > (uint32)(0xFFFF - psTimer->u16Missed))
+        {
+            psTimer->u16Missed = 0xFFFF;
+        }
+        else
+        {
+            psTimer->u16Missed += (uint16)u32Skip;
+        }
+
+        /* If this timer should prevent sleeping while running, increase the activity count again */
+        if(psTimer->u8Flags & TIMER_FLAG_PREVENT_SLEEP)
+        {
+            PWRM_vStartActivity(E_PWRM_ACTIVITY_TIMER);
+        }
+
+        psTimer->eState = E_TIMER_STATE_RUNNING;
+        TIMER_vInsert(tTimerIndex);
+
+    }
+
+}
+
+#ifdef TIMER_SUPPORT_PROFILING
+/****************************************************************************
+ *
+ * NAME: TIMER_vProfile
+ *
+ * DESCRIPTION:
+ * Adds one callback run to the profile of its timer
+ *
+ * RETURNS:
+ * void
+ *
+ ****************************************************************************/
+static void TIMER_vProfile(TIMER_tsTimer *psTimer, uint32 u32Exec, uint32 u32Late)
+{
+
+    psTimer->u32Runs++;
+    if(u32Exec >= TIMER_PROFILE_TICK)
+    {
+        psTimer->u32Overruns++;
+    }
+    if(u32Exec > psTimer->u32ExecMax)
+    {
+        psTimer->u32ExecMax = u32Exec;
+    }
+    if(u32Late > psTimer->u32LateMax)
+    {
+        psTimer->u32LateMax = u32Late;
+    }
+
+    TIMER_vProfileBin(psTimer->au16ExecHistogram, u32Exec);
+    TIMER_vProfileBin(psTimer->au16LateHistogram, u32Late);
+
+}
+
+
+/****************************************************************************
+ *
+ * NAME: TIMER_vProfileBin
+ *
+ * DESCRIPTION:
+ * Counts a value in the log2 bin of its bit length, saturating
+ *
+ * RETURNS:
+ * void
+ *
+ ****************************************************************************/
+static void TIMER_vProfileBin(uint16 *pu16Histogram, uint32 u32Value)
+{
+
+    uint8 u8Bin = 0;
+
+    while((u32Value != 0) && (u8Bin < (TIMER_PROFILE_BINS - 1)))
+    {
+        u32Value >>= 1;
+        u8Bin++;
+    }
+
+    if(pu16Histogram[u8Bin] < 0xFFFF)
+    {
+        pu16Histogram[u8Bin]++;
+    }
+
+}
+#endif
+
+#if (TIMER_BACKEND == TIMER_BACKEND_SCAN)
+
+/****************************************************************************
+ *
+ * NAME: TIMER_vInsert / TIMER_vRemove
+ *
+ * DESCRIPTION:
+ * Running timers are found by their state, nothing to link
+ *
+ ****************************************************************************/
+static void TIMER_vInsert(TIMER_tIndex tTimerIndex)
+{
+    (void)tTimerIndex;
+}
+
+static void TIMER_vRemove(TIMER_tIndex tTimerIndex)
+{
+    (void)tTimerIndex;
+}
+
+
+/****************************************************************************
+ *
+ * NAME: TIMER_vAdvance
+ *
+ * DESCRIPTION:
+ * Moves time on by u32Ticks and expires the running timers that are due, the
+ * earliest deadline first. Each scan of the array finds one timer to expire,
+ * so a long catch-up costs a scan per expiry rather than one per tick.
+ *
+ * RETURNS:
+ * void
+ *
+ ****************************************************************************/
+static void TIMER_vAdvance(uint32 u32Ticks)
+{
+
+    int n;
+    uint32 u32Target = TIMER_sCommon.u32Now + u32Ticks;
+    uint32 u32Left;
+    uint32 u32Earliest;
+    TIMER_tsTimer *psTimer;
+    TIMER_tsTimer *psEarliest;
+
+    for(;;)
+    {
+
+        psEarliest = NULL;
+        u32Earliest = u32Ticks;
+
+        /* Find the running timer with the earliest deadline up to the target */
+        for(n = 0; n < TIMER_sCommon.tNumTimers; n++)
+        {
+
+            psTimer = &TIMER_sCommon.psTimers[n];
+
+            /* If this timer is not running, move on to the next one */
+            if(psTimer->eState != E_TIMER_STATE_RUNNING)
+            {
+                continue;
+            }
+
+            u32Left = psTimer->u32Time - TIMER_sCommon.u32Now;
+            if((psEarliest == NULL && u32Left <= u32Earliest) || u32Left < u32Earliest)
+            {
+                psEarliest = psTimer;
+                u32Earliest = u32Left;
+            }
+
+        }
+
+        if(psEarliest == NULL)
+        {
+            break;
+        }
+
+        /* Callbacks see the time of their own deadline, so a restart from the
+         * callback is not shifted by the catch-up */
+        TIMER_sCommon.u32Now = psEarliest->u32Time;
+        u32Ticks = u32Target - TIMER_sCommon.u32Now;
+
+//        DBG_vPrintf(TRACE_TIMER, "ZT: Timer %d expired\n", psEarliest - TIMER_sCommon.psTimers);
+
+        TIMER_vExpire((TIMER_tIndex)(psEarliest - TIMER_sCommon.psTimers));
+
+    }
+
+    TIMER_sCommon.u32Now = u32Target;
+
+}
+
+#elif (TIMER_BACKEND == TIMER_BACKEND_WHEEL)
+
+static void TIMER_vWheelTick(void);
+
+/****************************************************************************
+ *
+ * NAME: TIMER_vInsert
+ *
+ * DESCRIPTION:
+ * Links a running timer into the wheel. A timer due in d ticks goes to the
+ * lowest level L with d < 2^(BITS*(L+1)), in the slot given by bits BITS*L
+ * and up of its deadline. When the levels below L wrap to zero the level L
+ * slot reached is emptied and its timers are inserted again, one level lower.
+ *
+ * RETURNS:
+ * void
+ *
+ ****************************************************************************/
+static void TIMER_vInsert(TIMER_tIndex tTimerIndex)
+{
+
+    TIMER_tsTimer *psTimer = &TIMER_sCommon.psTimers[tTimerIndex];
+    uint32 u32Deadline = psTimer->u32Time;
+    uint32 u32Delta = u32Deadline - TIMER_sCommon.u32Now;
+    uint8 u8Level = 0;
+    uint16 u16Slot;
+
+    /* Beyond the wheel: park the timer in the top level slot reached last,
+     * it is inserted again from there with the time still left */
+    if(u32Delta >= TIMER_WHEEL_RANGE)
+    {
+        u32Delta = TIMER_WHEEL_RANGE - 1;
+        u32Deadline = TIMER_sCommon.u32Now + u32Delta;
+    }
+
+    while((u8Level < (TIMER_WHEEL_LEVELS - 1)) && ((u32Delta >> (TIMER_WHEEL_BITS * (u8Level + 1))) != 0))
+    {
+        u8Level++;
+    }
+
+    u16Slot = (uint16)((u8Level * TIMER_WHEEL_SLOTS) + ((u32Deadline >> (TIMER_WHEEL_BITS * u8Level)) & TIMER_WHEEL_MASK));
+
+    psTimer->u16Slot = u16Slot;
+    psTimer->tPrev = TIMER_NONE;
+    psTimer->tNext = TIMER_sCommon.atWheel[u16Slot];
+    if(psTimer->tNext != TIMER_NONE)
+    {
+        TIMER_sCommon.psTimers[psTimer->tNext].tPrev = tTimerIndex;
+    }
+    TIMER_sCommon.atWheel[u16Slot] = tTimerIndex;
+
+}
+
+
+/****************************************************************************
+ *
+ * NAME: TIMER_vRemove
+ *
+ * DESCRIPTION:
+ * Unlinks a running timer from its wheel slot
+ *
+ * RETURNS:
+ * void
+ *
+ ****************************************************************************/
+static void TIMER_vRemove(TIMER_tIndex tTimerIndex)
+{
+
+    TIMER_tsTimer *psTimer = &TIMER_sCommon.psTimers[tTimerIndex];
+
+    if(psTimer->tPrev != TIMER_NONE)
+    {
+        TIMER_sCommon.psTimers[psTimer->tPrev].tNext = psTimer->tNext;
+    }
+    else
+    {
+        TIMER_sCommon.atWheel[psTimer->u16Slot] = psTimer->tNext;
+    }
+
+    if(psTimer->tNext != TIMER_NONE)
+    {
+        TIMER_sCommon.psTimers[psTimer->tNext].tPrev = psTimer->tPrev;
+    }
+
+}
+
+
+/****************************************************************************
+ *
+ * NAME: TIMER_vAdvance
+ *
+ * DESCRIPTION:
+ * Moves time on by u32Ticks, one tick at a time; each tick cascades the upper
+ * levels that were reached and expires the timers of the level 0 slot
+ *
+ * RETURNS:
+ * void
+ *
+ ****************************************************************************/
+static void TIMER_vAdvance(uint32 u32Ticks)
+{
+
+    while(u32Ticks-- > 0)
+    {
+        TIMER_vWheelTick();
+    }
+
+}
+
+
+static void TIMER_vWheelTick(void)
+{
+
+    uint8 u8Level;
+    TIMER_tIndex tTimerIndex;
+    uint16 u16Slot;
+
+    TIMER_sCommon.u32Now++;
+
+    /* A level is reached each time all the levels below it wrap to zero */
+    for(u8Level = 1; u8Level < TIMER_WHEEL_LEVELS; u8Level++)
+    {
+        if((TIMER_sCommon.u32Now & ((1UL << (TIMER_WHEEL_BITS * u8Level)) - 1)) != 0)
+        {
+            break;
+        }
+
+        u16Slot = (uint16)((u8Level * TIMER_WHEEL_SLOTS) + ((TIMER_sCommon.u32Now >> (TIMER_WHEEL_BITS * u8Level)) & TIMER_WHEEL_MASK));
+
+        /* Less than 2^(BITS*L) ticks are left, so none lands in this slot again */
+        while((tTimerIndex = TIMER_sCommon.atWheel[u16Slot]) != TIMER_NONE)
+        {
+            TIMER_vRemove(tTimerIndex);
+            TIMER_vInsert(tTimerIndex);
+        }
+    }
+
+    /* Every timer in the level 0 slot is due now. A callback can only restart a
+     * timer at least one tick ahead, which is never this slot. */
+    u16Slot = (uint16)(TIMER_sCommon.u32Now & TIMER_WHEEL_MASK);
+    while((tTimerIndex = TIMER_sCommon.atWheel[u16Slot]) != TIMER_NONE)
+    {
+        TIMER_vRemove(tTimerIndex);
+
+//        DBG_vPrintf(TRACE_TIMER, "ZT: Timer %d expired\n", tTimerIndex);
+
+        TIMER_vExpire(tTimerIndex);
+    }
+
+}
+
+#elif (TIMER_BACKEND == TIMER_BACKEND_SORTED)
+
+/****************************************************************************
+ *
+ * NAME: TIMER_vInsert
+ *
+ * DESCRIPTION:
+ * Links a running timer into the list in deadline order, after the timers
+ * with the same deadline so that they expire in the order they were started
+ *
+ * RETURNS:
+ * void
+ *
+ ****************************************************************************/
+static void TIMER_vInsert(TIMER_tIndex tTimerIndex)
+{
+
+    TIMER_tsTimer *psTimer = &TIMER_sCommon.psTimers[tTimerIndex];
+    uint32 u32Delta = psTimer->u32Time - TIMER_sCommon.u32Now;
+    TIMER_tIndex tPrev = TIMER_NONE;
+    TIMER_tIndex tNext = TIMER_sCommon.tHead;
+
+    /* Deadlines are compared as ticks from now so the list survives a wrap */
+    while((tNext != TIMER_NONE) &&
+          ((TIMER_sCommon.psTimers[tNext].u32Time - TIMER_sCommon.u32Now) <= u32Delta))
+    {
+        tPrev = tNext;
+        tNext = TIMER_sCommon.psTimers[tNext].tNext;
+    }
+
+    psTimer->tPrev = tPrev;
+    psTimer->tNext = tNext;
+
+    if(tPrev != TIMER_NONE)
+    {
+        TIMER_sCommon.psTimers[tPrev].tNext = tTimerIndex;
+    }
+    else
+    {
+        TIMER_sCommon.tHead = tTimerIndex;
+    }
+
+    if(tNext != TIMER_NONE)
+    {
+        TIMER_sCommon.psTimers[tNext].tPrev = tTimerIndex;
+    }
+
+}
+
+
+/****************************************************************************
+ *
+ * NAME: TIMER_vRemove
+ *
+ * DESCRIPTION:
+ * Unlinks a running timer from the list
+ *
+ * RETURNS:
+ * void
+ *
+ ****************************************************************************/
+static void TIMER_vRemove(TIMER_tIndex tTimerIndex)
+{
+
+    TIMER_tsTimer *psTimer = &TIMER_sCommon.psTimers[tTimerIndex];
+
+    if(psTimer->tPrev != TIMER_NONE)
+    {
+        TIMER_sCommon.psTimers[psTimer->tPrev].tNext = psTimer->tNext;
+    }
+    else
+    {
+        TIMER_sCommon.tHead = psTimer->tNext;
+    }
+
+    if(psTimer->tNext != TIMER_NONE)
+    {
+        TIMER_sCommon.psTimers[psTimer->tNext].tPrev = psTimer->tPrev;
+    }
+
+}
+
+
+/****************************************************************************
+ *
+ * NAME: TIMER_vAdvance
+ *
+ * DESCRIPTION:
+ * Moves time on by u32Ticks and expires the due timers from the head of the
+ * list; the first one not due ends the pass
+ *
+ * RETURNS:
+ * void
+ *
+ ****************************************************************************/
+static void TIMER_vAdvance(uint32 u32Ticks)
+{
+
+    TIMER_tIndex tTimerIndex;
+    uint32 u32Target = TIMER_sCommon.u32Now + u32Ticks;
+
+    while(((tTimerIndex = TIMER_sCommon.tHead) != TIMER_NONE) &&
+          TIMER_IS_DUE(TIMER_sCommon.psTimers[tTimerIndex].u32Time, TIMER_sCommon.u32Now, u32Target))
+    {
+        TIMER_vRemove(tTimerIndex);
+
+        /* Callbacks see the time of their own deadline, so a restart from the
+         * callback is not shifted by the catch-up */
+        TIMER_sCommon.u32Now = TIMER_sCommon.psTimers[tTimerIndex].u32Time;
+
+//        DBG_vPrintf(TRACE_TIMER, "ZT: Timer %d expired\n", tTimerIndex);
+
+        TIMER_vExpire(tTimerIndex);
+    }
+
+    TIMER_sCommon.u32Now = u32Target;
+
+}
+
+#else
+#error "Unknown TIMER_BACKEND"
+#endif
 
 /****************************************************************************/
 /*          END OF FILE                                                     */
@@ -45,9 +45,92 @@
 #define TIMER_TIME_SEC(v) ((uint32)(v) * 1000UL)
 #define TIMER_TIME_MSEC(v) ((uint32)(v) * 1UL)
 
+/* Timer backend, selects how running timers are kept:
+ * TIMER_BACKEND_SCAN  - every tick walks the whole timer array (smallest RAM)
+ * TIMER_BACKEND_WHEEL - hierarchical timing wheel, a tick costs O(1) plus the
+ *                       timers that expire or move down a level
+ * TIMER_BACKEND_SORTED - list sorted on deadline, a tick only looks at the head
+ *                       and starting a timer walks the list; two bytes a timer */
+#define TIMER_BACKEND_SCAN         0
+#define TIMER_BACKEND_WHEEL        1
+#define TIMER_BACKEND_SORTED       2
+
+#ifndef TIMER_BACKEND
+#define TIMER_BACKEND              TIMER_BACKEND_SCAN
+#endif
+
+/* Wheel geometry: TIMER_WHEEL_LEVELS levels of 2^TIMER_WHEEL_BITS slots, one
+ * uint8 list head per slot. The default covers 2^24 ticks (4.6 hours at 1 ms)
+ * with 256 bytes; longer timers are re-queued when the top level wraps. */
+#ifndef TIMER_WHEEL_BITS
+#define TIMER_WHEEL_BITS           6
+#endif
+#ifndef TIMER_WHEEL_LEVELS
+#define TIMER_WHEEL_LEVELS         4
+#endif
+
+/* Width of a timer handle: 16 or 32 bits. The low half is the timer index and
+ * the high half a generation bumped on every TIMER_eClose, so a handle kept
+ * after its timer was closed is rejected instead of acting on the timer that
+ * reused the slot. 16 bits allow 254 timers, 32 bits 65534. */
+#ifndef TIMER_HANDLE_WIDTH
+#if (defined STM32F10X_MD)
+#define TIMER_HANDLE_WIDTH         (32)
+#else
+#define TIMER_HANDLE_WIDTH         (16)
+#endif
+#endif
+
+#if (TIMER_HANDLE_WIDTH == 16)
+typedef uint16 TIMER_tHandle;
+typedef uint8  TIMER_tIndex;
+#elif (TIMER_HANDLE_WIDTH == 32)
+typedef uint32 TIMER_tHandle;
+typedef uint16 TIMER_tIndex;
+#else
+#error "TIMER_HANDLE_WIDTH must be 16 or 32"
+#endif
+
+#define TIMER_INDEX_BITS           (TIMER_HANDLE_WIDTH / 2)
+
+/* The generation is never 0, so a zeroed handle never refers to a timer */
+#define TIMER_INVALID_HANDLE       ((TIMER_tHandle)0)
+
+/* Absolute time in ticks (ms) since TIMER_eInit, as read by TIMER_u64NowMs and
+ * taken by TIMER_eStartAt. 64 bits where the compiler has them; IAR for STM8
+ * has no 64 bit integer, there it is 32 bits and wraps after 49.7 days. */
+#ifdef uint64
+typedef uint64 TIMER_tTime;
+#else
+typedef uint32 TIMER_tTime;
+#endif
+
+/* Returned by TIMER_u32NextExpiry / TIMER_u32NextWakeup when no timer is running */
+#define TIMER_NO_EXPIRY            0xFFFFFFFFUL
+
 /* Flags for timer configuration */
 #define TIMER_FLAG_ALLOW_SLEEP     0
 #define TIMER_FLAG_PREVENT_SLEEP   (1 << 0)
+/* The timer reloads itself with the period given to TIMER_eStart, counted from
+ * its previous deadline rather than from when the callback ran. Periods that
+ * went by entirely during an overload are skipped and counted, see
+ * TIMER_u16GetMissed; stop it with TIMER_eStop, also from its callback. */
+#define TIMER_FLAG_PERIODIC        (1 << 1)
+
+/* Define TIMER_SUPPORT_PROFILING to measure every callback TIMER_vTask runs:
+ * how long it took (core cycles where the port has a cycle counter, us from the
+ * time base otherwise) and how late it started after its deadline (us). Each
+ * timer keeps the maximum and a log2 histogram of both, bin 0 counting zero,
+ * bin n the values from 2^(n-1) to 2^n - 1 and the last bin all above, plus
+ * the runs that took a whole tick or more; TIMER_vDumpProfile prints them.
+ * The default bins reach 3.6 ms of cycles at 72 MHz, 1 ms of us on STM8. */
+#ifndef TIMER_PROFILE_BINS
+#if (defined STM32F10X_MD)
+#define TIMER_PROFILE_BINS         (20)
+#else
+#define TIMER_PROFILE_BINS         (12)
+#endif
+#endif
 
 /****************************************************************************/
 /***        Type Definitions                                              ***/
@@ -66,9 +149,28 @@ typedef struct
 {
     uint8               u8Flags;
     TIMER_teState       eState;
-    uint32              u32Time;
+    TIMER_tIndex        tGeneration;    /* High half of the handles of this slot */
+    uint32              u32Time;        /* Tick count at which a running timer expires */
+    uint32              u32Period;      /* Time given to TIMER_eStart, reload of a periodic timer */
+    uint16              u16Missed;      /* Periods skipped since TIMER_eStart, saturates */
+    uint16              u16Slack;       /* Ticks the expiry may be late to share a wakeup */
     void                *pvParameters;
     TIMER_tpfCallback   pfCallback;
+    TIMER_tIndex        tNext;          /* Next timer in the free list / same wheel slot / sorted list */
+#if (TIMER_BACKEND == TIMER_BACKEND_WHEEL) || (TIMER_BACKEND == TIMER_BACKEND_SORTED)
+    TIMER_tIndex        tPrev;          /* Previous timer in the same wheel slot / sorted list */
+#endif
+#if (TIMER_BACKEND == TIMER_BACKEND_WHEEL)
+    uint16              u16Slot;        /* Wheel slot holding the timer */
+#endif
+#ifdef TIMER_SUPPORT_PROFILING
+    uint32              u32Runs;        /* Callbacks run since TIMER_eOpen / TIMER_vResetProfile */
+    uint32              u32Overruns;    /* Runs that took a tick or more */
+    uint32              u32ExecMax;     /* Longest run */
+    uint32              u32LateMax;     /* Latest start after the deadline, us */
+    uint16              au16ExecHistogram[TIMER_PROFILE_BINS];
+    uint16              au16LateHistogram[TIMER_PROFILE_BINS];
+#endif
 } TIMER_tsTimer;
 
 typedef enum
@@ -81,7 +183,7 @@ typedef enum
 /***        Exported Functions                                            ***/
 /****************************************************************************/
 
-TIMER_teStatus TIMER_eInit(TIMER_tsTimer *psTimers, uint8 u8NumTimers);
+TIMER_teStatus TIMER_eInit(TIMER_tsTimer *psTimers, uint16 u16NumTimers);
 #if (JENNIC_CHIP_FAMILY == JN516x)
 void ISR_vTickTimer(void);
 #else
@@ -90,11 +192,27 @@ PUBLIC void TIMER_vAhiCallback ( uint32 u32Device, uint32 u32ItemBitmap);
 void TIMER_vSleep(void);
 void TIMER_vWake(void);
 void TIMER_vTask(void);
-TIMER_teStatus TIMER_eOpen(uint8 *pu8TimerIndex, TIMER_tpfCallback pfCallback, void *pvParams, uint8 u8Flags);
-TIMER_teStatus TIMER_eClose(uint8 u8TimerIndex);
-TIMER_teStatus TIMER_eStart(uint8 u8TimerIndex, uint32 u32Time);
-TIMER_teStatus TIMER_eStop(uint8 u8TimerIndex);
-TIMER_teState TIMER_eGetState(uint8 u8TimerIndex);
+bool_t TIMER_bIsTickPending(void);
+uint32 TIMER_u32NextExpiry(void);
+uint32 TIMER_u32NextWakeup(void);
+uint32 TIMER_u32NowMs(void);
+uint32 TIMER_u32NowUs(void);
+#ifdef uint64
+uint64 TIMER_u64NowMs(void);
+uint64 TIMER_u64NowUs(void);
+#endif
+TIMER_teStatus TIMER_eOpen(TIMER_tHandle *ptTimer, TIMER_tpfCallback pfCallback, void *pvParams, uint8 u8Flags);
+TIMER_teStatus TIMER_eClose(TIMER_tHandle tTimer);
+TIMER_teStatus TIMER_eStart(TIMER_tHandle tTimer, uint32 u32Time);
+TIMER_teStatus TIMER_eStartAt(TIMER_tHandle tTimer, TIMER_tTime tDeadline);
+TIMER_teStatus TIMER_eSetSlack(TIMER_tHandle tTimer, uint16 u16Slack);
+TIMER_teStatus TIMER_eStop(TIMER_tHandle tTimer);
+TIMER_teState TIMER_eGetState(TIMER_tHandle tTimer);
+uint16 TIMER_u16GetMissed(TIMER_tHandle tTimer);
+#ifdef TIMER_SUPPORT_PROFILING
+void TIMER_vResetProfile(void);
+void TIMER_vDumpProfile(void);
+#endif
 
 /****************************************************************************/
 /***        External Variables                                            ***/
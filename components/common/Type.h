@@ -61,6 +61,11 @@
 #define int32           int32_t
 #endif
 
+/* Only where the compiler has a 64 bit type, IAR for STM8 does not */
+#if (defined UINT64_MAX) && !(defined uint64)
+#define uint64          uint64_t
+#endif
+
 #ifndef FALSE
 #define FALSE           (bool)0
 #endif
@@ -0,0 +1,352 @@
+/*****************************************************************************
+ *
+ * MODULE:             Kernel
+ *
+ * COMPONENT:          cmsis_os.h
+ *
+ * DESCRIPTION:        CMSIS-RTOS API of the preemptive kernel
+ *
+ * Implements the thread, delay, timer, semaphore and message queue functions
+ * of CMSIS-RTOS V1.02 on os_kernel.c. Mutexes, signals, memory pools, mail
+ * queues and osWait are not available (see the osFeature_ defines). Objects
+ * are defined with their control block and storage, nothing is allocated at
+ * run time. The declarations follow the ARM template header:
+ *
+ * Copyright (c) 2013 ARM LIMITED
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  - Neither the name of ARM  nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ ****************************************************************************
+ *
+ * This software is owned by NXP B.V. and/or its supplier and is protected
+ * under applicable copyright laws. All rights are reserved. We grant You,
+ * and any third parties, a license to use this software solely and
+ * exclusively on NXP products [NXP Microcontrollers such as JN5168, JN5179].
+ * You, and any third parties must reproduce the copyright and warranty notice
+ * and any other legend of ownership on each copy or partial copy of the
+ * software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Copyright NXP B.V. 2016. All rights reserved
+ *
+ ***************************************************************************/
+
+#ifndef CMSIS_OS_H_
+#define CMSIS_OS_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "Queue.h"
+#include "Timer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/****************************************************************************/
+/***        Macro Definitions                                             ***/
+/****************************************************************************/
+
+#define osCMSIS                 0x10002         /* API version */
+#define osCMSIS_KERNEL          0x10000         /* Kernel version */
+#define osKernelSystemId        "SDK_MCUS V1.00"
+
+#define osFeature_MainThread    0               /* osKernelStart does not return */
+#define osFeature_Pool          0
+#define osFeature_MailQ         0
+#define osFeature_MessageQ      1
+#define osFeature_Signals       0
+#define osFeature_Semaphore     65535           /* Highest semaphore count */
+#define osFeature_Wait          0
+#define osFeature_SysTick       1
+
+#define osWaitForever           0xFFFFFFFF
+
+/* osKernelSysTick is TIMER_u32NowUs */
+#define osKernelSysTickFrequency 1000000
+#define osKernelSysTickMicroSec(microsec) ((uint32_t)(microsec))
+
+/* Threads the kernel can hold, its idle and timer threads included */
+#ifndef OS_MAX_THREADS
+#define OS_MAX_THREADS          (8)
+#endif
+
+/* Stack of a thread defined with a stack size of 0, in bytes. A switched out
+ * thread keeps 64 bytes of registers on its stack. */
+#ifndef OS_STACK_SIZE
+#define OS_STACK_SIZE           (512)
+#endif
+#ifndef OS_IDLE_STACK_SIZE
+#define OS_IDLE_STACK_SIZE      (128)
+#endif
+
+/* The timer thread runs TIMER_vTask, so the callbacks of osTimer and of every
+ * other TIMER_* timer, with the scheduler locked: a callback must not wait
+ * and threads of a higher priority only run once it returns */
+#ifndef OS_TIMER_PRIORITY
+#define OS_TIMER_PRIORITY       osPriorityHigh
+#endif
+#ifndef OS_TIMER_STACK_SIZE
+#define OS_TIMER_STACK_SIZE     (512)
+#endif
+
+#define OS_STACK_WORDS(stacksz) (((((stacksz) != 0) ? (stacksz) : OS_STACK_SIZE) + 3) / 4)
+
+/****************************************************************************/
+/***        Type Definitions                                              ***/
+/****************************************************************************/
+
+typedef enum
+{
+    osPriorityIdle          = -3,
+    osPriorityLow           = -2,
+    osPriorityBelowNormal   = -1,
+    osPriorityNormal        =  0,
+    osPriorityAboveNormal   = +1,
+    osPriorityHigh          = +2,
+    osPriorityRealtime      = +3,
+    osPriorityError         =  0x84
+} osPriority;
+
+typedef enum
+{
+    osOK                    =     0,
+    osEventSignal           =  0x08,
+    osEventMessage          =  0x10,
+    osEventMail             =  0x20,
+    osEventTimeout          =  0x40,
+    osErrorParameter        =  0x80,
+    osErrorResource         =  0x81,
+    osErrorTimeoutResource  =  0xC1,
+    osErrorISR              =  0x82,
+    osErrorISRRecursive     =  0x83,
+    osErrorPriority         =  0x84,
+    osErrorNoMemory         =  0x85,
+    osErrorValue            =  0x86,
+    osErrorOS               =  0xFF,
+    os_status_reserved      =  0x7FFFFFFF
+} osStatus;
+
+typedef enum
+{
+    osTimerOnce             =     0,
+    osTimerPeriodic         =     1
+} os_timer_type;
+
+typedef void (*os_pthread) (void const *argument);
+typedef void (*os_ptimer) (void const *argument);
+
+typedef struct os_thread_cb *osThreadId;
+typedef struct os_timer_cb *osTimerId;
+typedef struct os_semaphore_cb *osSemaphoreId;
+typedef struct os_messageQ_cb *osMessageQId;
+
+/* Control blocks, defined with their object by the osXxxDef macros and only
+ * accessed by the kernel and its ports */
+struct os_thread_cb
+{
+    uint32_t            *pu32Sp;        /* Saved stack pointer; first, the context switch relies on it */
+    os_pthread          pfThread;
+    void                *pvArgument;
+    uint32_t            *pu32Stack;     /* Lowest word of the stack */
+    uint32_t            u32StackWords;
+    const void          *pvWaitObject;  /* Object a waiting thread waits on */
+    uint32_t            u32Timeout;     /* Ticks left to wait, osWaitForever: no timeout */
+    uint32_t            u32Message;     /* Message handed over to a thread waiting in osMessageGet */
+    osStatus            eWaitResult;    /* Why the wait ended */
+    int8_t              i8Priority;     /* osPriority, one below osPriorityIdle for the idle thread */
+    uint8_t             u8State;
+    uint8_t             u8Wait;         /* What a waiting thread waits for */
+    uint8_t             u8Slot;         /* Index in the kernel's thread table */
+#ifdef PORTABLE_RTOS_POSIX
+    void                *pvPort;        /* Host thread running it */
+#endif
+};
+
+struct os_timer_cb
+{
+    TIMER_tHandle       tTimer;
+    os_ptimer           pfCallback;
+    void                *pvArgument;
+    uint8_t             bCreated;
+};
+
+struct os_semaphore_cb
+{
+    int32_t             i32Count;
+    uint8_t             bCreated;
+};
+
+/* Messages are 32 bit values kept in a tsQueue */
+struct os_messageQ_cb
+{
+    tsQueue             sQueue;
+    uint8_t             bCreated;
+};
+
+typedef struct os_thread_def
+{
+    os_pthread          pthread;
+    osPriority          tpriority;
+    uint32_t            instances;
+    uint32_t            stacksize;      /* Bytes for each instance, 0: OS_STACK_SIZE */
+    struct os_thread_cb *cb;            /* One control block for each instance */
+    uint32_t            *stack;
+} osThreadDef_t;
+
+typedef struct os_timer_def
+{
+    os_ptimer           ptimer;
+    struct os_timer_cb  *cb;
+} osTimerDef_t;
+
+typedef struct os_semaphore_def
+{
+    struct os_semaphore_cb *cb;
+} osSemaphoreDef_t;
+
+typedef struct os_messageQ_def
+{
+    uint32_t            queue_sz;
+    uint32_t            item_sz;
+    void                *pool;          /* queue_sz uint32_t */
+    struct os_messageQ_cb *cb;
+} osMessageQDef_t;
+
+typedef struct
+{
+    osStatus            status;
+    union
+    {
+        uint32_t        v;
+        void            *p;
+        int32_t         signals;
+    } value;
+    union
+    {
+        osMessageQId    message_id;
+    } def;
+} osEvent;
+
+/****************************************************************************/
+/***        Object Definitions                                            ***/
+/****************************************************************************/
+
+#if defined (osObjectsExternal)
+#define osThreadDef(name, priority, instances, stacksz) \
+extern const osThreadDef_t os_thread_def_##name
+#else
+#define osThreadDef(name, priority, instances, stacksz) \
+static uint32_t os_thread_stack_##name[(instances) * OS_STACK_WORDS(stacksz)]; \
+static struct os_thread_cb os_thread_cb_##name[instances]; \
+const osThreadDef_t os_thread_def_##name = \
+{ (name), (priority), (instances), (stacksz), os_thread_cb_##name, os_thread_stack_##name }
+#endif
+#define osThread(name)  &os_thread_def_##name
+
+#if defined (osObjectsExternal)
+#define osTimerDef(name, function) \
+extern const osTimerDef_t os_timer_def_##name
+#else
+#define osTimerDef(name, function) \
+static struct os_timer_cb os_timer_cb_##name; \
+const osTimerDef_t os_timer_def_##name = { (function), &os_timer_cb_##name }
+#endif
+#define osTimer(name)   &os_timer_def_##name
+
+#if defined (osObjectsExternal)
+#define osSemaphoreDef(name) \
+extern const osSemaphoreDef_t os_semaphore_def_##name
+#else
+#define osSemaphoreDef(name) \
+static struct os_semaphore_cb os_semaphore_cb_##name; \
+const osSemaphoreDef_t os_semaphore_def_##name = { &os_semaphore_cb_##name }
+#endif
+#define osSemaphore(name) &os_semaphore_def_##name
+
+#if defined (osObjectsExternal)
+#define osMessageQDef(name, queue_sz, type) \
+extern const osMessageQDef_t os_messageQ_def_##name
+#else
+#define osMessageQDef(name, queue_sz, type) \
+static uint32_t os_messageQ_pool_##name[queue_sz]; \
+static struct os_messageQ_cb os_messageQ_cb_##name; \
+const osMessageQDef_t os_messageQ_def_##name = \
+{ (queue_sz), sizeof (type), os_messageQ_pool_##name, &os_messageQ_cb_##name }
+#endif
+#define osMessageQ(name) &os_messageQ_def_##name
+
+/****************************************************************************/
+/***        Exported Functions                                            ***/
+/****************************************************************************/
+
+osStatus osKernelInitialize(void);
+osStatus osKernelStart(void);
+int32_t osKernelRunning(void);
+uint32_t osKernelSysTick(void);
+
+osThreadId osThreadCreate(const osThreadDef_t *thread_def, void *argument);
+osThreadId osThreadGetId(void);
+osStatus osThreadTerminate(osThreadId thread_id);
+osStatus osThreadYield(void);
+osStatus osThreadSetPriority(osThreadId thread_id, osPriority priority);
+osPriority osThreadGetPriority(osThreadId thread_id);
+osStatus osDelay(uint32_t millisec);
+
+osTimerId osTimerCreate(const osTimerDef_t *timer_def, os_timer_type type, void *argument);
+osStatus osTimerStart(osTimerId timer_id, uint32_t millisec);
+osStatus osTimerStop(osTimerId timer_id);
+osStatus osTimerDelete(osTimerId timer_id);
+
+osSemaphoreId osSemaphoreCreate(const osSemaphoreDef_t *semaphore_def, int32_t count);
+int32_t osSemaphoreWait(osSemaphoreId semaphore_id, uint32_t millisec);
+osStatus osSemaphoreRelease(osSemaphoreId semaphore_id);
+osStatus osSemaphoreDelete(osSemaphoreId semaphore_id);
+
+osMessageQId osMessageCreate(const osMessageQDef_t *queue_def, osThreadId thread_id);
+osStatus osMessagePut(osMessageQId queue_id, uint32_t info, uint32_t millisec);
+osEvent osMessageGet(osMessageQId queue_id, uint32_t millisec);
+
+/* Kernel side of the port: OS_vTick is called by the 1 ms time base interrupt
+ * after ISR_vTickTimer; the context switch saves the running thread into
+ * OS_psCurrent, makes OS_psNext current and resumes it; a thread function that
+ * returns ends in OS_vThreadReturn */
+void OS_vTick(void);
+void OS_vThreadReturn(void);
+
+/****************************************************************************/
+/***        External Variables                                            ***/
+/****************************************************************************/
+
+extern struct os_thread_cb *volatile OS_psCurrent;
+extern struct os_thread_cb *volatile OS_psNext;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*CMSIS_OS_H_*/
+
+/****************************************************************************/
+/***        END OF FILE                                                   ***/
+/****************************************************************************/
@@ -0,0 +1,894 @@
+/*****************************************************************************
+ *
+ * MODULE:             Kernel
+ *
+ * COMPONENT:          os_kernel.c
+ *
+ * DESCRIPTION:        Preemptive priority kernel behind cmsis_os.h
+ *
+ * The highest priority ready thread runs; threads of equal priority share the
+ * CPU in turns of a tick. Everything the kernel keeps is changed inside
+ * PORTABLE_u8EnterCritical, the switch itself is left to the port, which takes
+ * it once the critical section is left (PendSV on Cortex-M). Threads are held
+ * in a small table that every decision walks: with OS_MAX_THREADS of 8 this is
+ * shorter than keeping ready lists up to date.
+ *
+ ****************************************************************************
+ *
+ * This software is owned by NXP B.V. and/or its supplier and is protected
+ * under applicable copyright laws. All rights are reserved. We grant You,
+ * and any third parties, a license to use this software solely and
+ * exclusively on NXP products [NXP Microcontrollers such as JN5168, JN5179].
+ * You, and any third parties must reproduce the copyright and warranty notice
+ * and any other legend of ownership on each copy or partial copy of the
+ * software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Copyright NXP B.V. 2016. All rights reserved
+ *
+ ***************************************************************************/
+
+/****************************************************************************/
+/***        Include files                                                 ***/
+/****************************************************************************/
+
+#include "chip_selection.h"
+#include "cmsis_os.h"
+#include "port_mcu.h"
+
+#ifdef PORTABLE_SUPPORT_RTOS
+
+#ifdef TIMER_SUPPORT_TICKLESS
+#error "The kernel needs every tick, TIMER_SUPPORT_TICKLESS can not be used with it"
+#endif
+
+/****************************************************************************/
+/***        Macro Definitions                                             ***/
+/****************************************************************************/
+
+/* Thread states; a terminated thread is unused again */
+#define OS_STATE_UNUSED         (0)
+#define OS_STATE_READY          (1)
+#define OS_STATE_WAITING        (2)
+
+/* What a waiting thread waits for */
+#define OS_WAIT_DELAY           (0)
+#define OS_WAIT_TIMER           (1)
+#define OS_WAIT_SEMAPHORE       (2)
+#define OS_WAIT_MESSAGE         (3)     /* A message in an empty queue */
+#define OS_WAIT_SPACE           (4)     /* Room in a full queue */
+
+#define OS_IDLE_PRIORITY        (osPriorityIdle - 1)
+
+/****************************************************************************/
+/***        Type Definitions                                              ***/
+/****************************************************************************/
+
+typedef struct
+{
+    struct os_thread_cb *apsThreads[OS_MAX_THREADS];
+    uint8               u8NumThreads;
+    uint8               u8Lock;         /*< Scheduler lock depth, switches wait while set. */
+    bool_t              bInitialised;
+    bool_t              bRunning;
+}OS_tsCommon;
+
+/****************************************************************************/
+/***        Local Function Prototypes                                     ***/
+/****************************************************************************/
+
+static void OS_vInit(void);
+static bool_t OS_bThreadInit(struct os_thread_cb *psThread, os_pthread pfThread, void *pvArgument,
+                             int8_t i8Priority, uint32 *pu32Stack, uint32 u32StackWords);
+static void OS_vReschedule(bool_t bRotate);
+static osStatus OS_eWait(uint8 u8Wait, const void *pvObject, uint32 u32Millisec, uint8 *pu8State);
+static struct os_thread_cb *OS_psWake(uint8 u8Wait, const void *pvObject, osStatus eResult);
+static bool_t OS_bCanWait(void);
+static void OS_vLock(void);
+static void OS_vUnlock(void);
+static void OS_vIdleThread(void const *pvArgument);
+static void OS_vTimerThread(void const *pvArgument);
+static void OS_vTimerCallback(void *pvParam);
+
+/****************************************************************************/
+/***        Exported Variables                                            ***/
+/****************************************************************************/
+
+struct os_thread_cb *volatile OS_psCurrent;
+struct os_thread_cb *volatile OS_psNext;
+
+/****************************************************************************/
+/***        Local Variables                                               ***/
+/****************************************************************************/
+
+static OS_tsCommon OS_sCommon;
+static struct os_thread_cb OS_sIdleThread;
+static struct os_thread_cb OS_sTimerThread;
+static uint32 OS_au32IdleStack[OS_STACK_WORDS(OS_IDLE_STACK_SIZE)];
+static uint32 OS_au32TimerStack[OS_STACK_WORDS(OS_TIMER_STACK_SIZE)];
+
+/****************************************************************************/
+/***        Exported Functions                                            ***/
+/****************************************************************************/
+
+/***  Kernel control  ***/
+
+osStatus osKernelInitialize(void)
+{
+    if (OS_sCommon.bRunning)
+    {
+        return osErrorOS;
+    }
+
+    OS_vInit();
+    return osOK;
+}
+
+/* Runs the highest priority thread and never returns; main is not a thread */
+osStatus osKernelStart(void)
+{
+    if (OS_sCommon.bRunning || PORTABLE_bOsInIsr())
+    {
+        return osErrorOS;
+    }
+
+    OS_vInit();
+
+    (void)PORTABLE_u8EnterCritical();
+    OS_sCommon.bRunning = TRUE;
+    OS_vReschedule(FALSE);
+    PORTABLE_vOsStart();
+
+    return osErrorOS;
+}
+
+int32_t osKernelRunning(void)
+{
+    return OS_sCommon.bRunning ? 1 : 0;
+}
+
+uint32_t osKernelSysTick(void)
+{
+    return TIMER_u32NowUs();
+}
+
+/* Counts the tick down for the waiting threads, hands the TIMER_* tick to the
+ * timer thread and gives the next thread of the running priority its turn */
+void OS_vTick(void)
+{
+    struct os_thread_cb *psThread;
+    uint8 u8State;
+    uint8 u8Slot;
+
+    u8State = PORTABLE_u8EnterCritical();
+
+    for (u8Slot = 0; u8Slot < OS_sCommon.u8NumThreads; u8Slot++)
+    {
+        psThread = OS_sCommon.apsThreads[u8Slot];
+        if (psThread->u8State == OS_STATE_WAITING && psThread->u32Timeout != osWaitForever)
+        {
+            if (--psThread->u32Timeout == 0)
+            {
+                psThread->u8State = OS_STATE_READY;
+                psThread->eWaitResult = osEventTimeout;
+            }
+        }
+    }
+
+    if (TIMER_bIsTickPending())
+    {
+        (void)OS_psWake(OS_WAIT_TIMER, NULL, osOK);
+    }
+
+    OS_vReschedule(TRUE);
+    PORTABLE_vExitCritical(u8State);
+}
+
+void OS_vThreadReturn(void)
+{
+    (void)osThreadTerminate(OS_psCurrent);
+    for (;;)
+    {
+    }
+}
+
+/***  Threads  ***/
+
+/* Starts the first unused instance of thread_def. A thread of a higher
+ * priority than the caller runs at once. */
+osThreadId osThreadCreate(const osThreadDef_t *thread_def, void *argument)
+{
+    struct os_thread_cb *psThread = NULL;
+    uint32 u32StackWords;
+    uint32 u32Instance;
+    uint8 u8State;
+
+    if (thread_def == NULL || thread_def->pthread == NULL ||
+        thread_def->tpriority < osPriorityIdle || thread_def->tpriority > osPriorityRealtime ||
+        PORTABLE_bOsInIsr())
+    {
+        return NULL;
+    }
+
+    OS_vInit();
+    u32StackWords = OS_STACK_WORDS(thread_def->stacksize);
+
+    u8State = PORTABLE_u8EnterCritical();
+    for (u32Instance = 0; u32Instance < thread_def->instances; u32Instance++)
+    {
+        if (thread_def->cb[u32Instance].u8State == OS_STATE_UNUSED)
+        {
+            psThread = &thread_def->cb[u32Instance];
+            if (!OS_bThreadInit(psThread, thread_def->pthread, argument, (int8_t)thread_def->tpriority,
+                                &thread_def->stack[u32Instance * u32StackWords], u32StackWords))
+            {
+                psThread = NULL;
+            }
+            break;
+        }
+    }
+    OS_vReschedule(FALSE);
+    PORTABLE_vExitCritical(u8State);
+
+    return psThread;
+}
+
+osThreadId osThreadGetId(void)
+{
+    return OS_psCurrent;
+}
+
+/* The control block and stack of a terminated thread are free for the next
+ * osThreadCreate of its definition */
+osStatus osThreadTerminate(osThreadId thread_id)
+{
+    uint8 u8State;
+
+    if (PORTABLE_bOsInIsr())
+    {
+        return osErrorISR;
+    }
+    if (thread_id == NULL || thread_id->u8State == OS_STATE_UNUSED ||
+        thread_id == &OS_sIdleThread || thread_id == &OS_sTimerThread)
+    {
+        return osErrorParameter;
+    }
+
+    u8State = PORTABLE_u8EnterCritical();
+    thread_id->u8State = OS_STATE_UNUSED;
+    OS_vReschedule(FALSE);
+    PORTABLE_vExitCritical(u8State);
+
+    return osOK;
+}
+
+osStatus osThreadYield(void)
+{
+    uint8 u8State;
+
+    if (PORTABLE_bOsInIsr())
+    {
+        return osErrorISR;
+    }
+
+    u8State = PORTABLE_u8EnterCritical();
+    OS_vReschedule(TRUE);
+    PORTABLE_vExitCritical(u8State);
+
+    return osOK;
+}
+
+osStatus osThreadSetPriority(osThreadId thread_id, osPriority priority)
+{
+    uint8 u8State;
+
+    if (PORTABLE_bOsInIsr())
+    {
+        return osErrorISR;
+    }
+    if (thread_id == NULL || thread_id->u8State == OS_STATE_UNUSED ||
+        thread_id == &OS_sIdleThread || thread_id == &OS_sTimerThread)
+    {
+        return osErrorParameter;
+    }
+    if (priority < osPriorityIdle || priority > osPriorityRealtime)
+    {
+        return osErrorValue;
+    }
+
+    u8State = PORTABLE_u8EnterCritical();
+    thread_id->i8Priority = (int8_t)priority;
+    OS_vReschedule(FALSE);
+    PORTABLE_vExitCritical(u8State);
+
+    return osOK;
+}
+
+osPriority osThreadGetPriority(osThreadId thread_id)
+{
+    if (thread_id == NULL || thread_id->u8State == OS_STATE_UNUSED || thread_id == &OS_sIdleThread)
+    {
+        return osPriorityError;
+    }
+
+    return (osPriority)thread_id->i8Priority;
+}
+
+/* Waits millisec ticks, the first one ending at the next tick boundary */
+osStatus osDelay(uint32_t millisec)
+{
+    uint8 u8State;
+
+    if (PORTABLE_bOsInIsr())
+    {
+        return osErrorISR;
+    }
+    if (millisec == 0)
+    {
+        return osThreadYield();
+    }
+    if (!OS_bCanWait())
+    {
+        return osErrorOS;
+    }
+
+    u8State = PORTABLE_u8EnterCritical();
+    (void)OS_eWait(OS_WAIT_DELAY, NULL, millisec, &u8State);
+    PORTABLE_vExitCritical(u8State);
+
+    return osEventTimeout;
+}
+
+/***  Timers  ***/
+
+/* An osTimer is a TIMER_* timer whose callback runs in the timer thread, so
+ * TIMER_eInit must have room for it */
+osTimerId osTimerCreate(const osTimerDef_t *timer_def, os_timer_type type, void *argument)
+{
+    struct os_timer_cb *psTimer;
+    TIMER_teStatus eStatus;
+
+    if (timer_def == NULL || timer_def->ptimer == NULL || timer_def->cb->bCreated || PORTABLE_bOsInIsr())
+    {
+        return NULL;
+    }
+
+    psTimer = timer_def->cb;
+    psTimer->pfCallback = timer_def->ptimer;
+    psTimer->pvArgument = argument;
+
+    OS_vLock();
+    eStatus = TIMER_eOpen(&psTimer->tTimer, OS_vTimerCallback, psTimer,
+                          (type == osTimerPeriodic) ? TIMER_FLAG_PERIODIC : TIMER_FLAG_ALLOW_SLEEP);
+    OS_vUnlock();
+
+    if (eStatus != E_TIMER_OK)
+    {
+        return NULL;
+    }
+
+    psTimer->bCreated = TRUE;
+    return psTimer;
+}
+
+/* Starts or restarts the timer, a periodic one with millisec as its period */
+osStatus osTimerStart(osTimerId timer_id, uint32_t millisec)
+{
+    TIMER_teStatus eStatus;
+
+    if (PORTABLE_bOsInIsr())
+    {
+        return osErrorISR;
+    }
+    if (timer_id == NULL || !timer_id->bCreated)
+    {
+        return osErrorParameter;
+    }
+    if (millisec == 0)
+    {
+        return osErrorValue;
+    }
+
+    OS_vLock();
+    eStatus = TIMER_eStart(timer_id->tTimer, millisec);
+    OS_vUnlock();
+
+    return (eStatus == E_TIMER_OK) ? osOK : osErrorResource;
+}
+
+osStatus osTimerStop(osTimerId timer_id)
+{
+    osStatus eStatus = osErrorResource;
+
+    if (PORTABLE_bOsInIsr())
+    {
+        return osErrorISR;
+    }
+    if (timer_id == NULL || !timer_id->bCreated)
+    {
+        return osErrorParameter;
+    }
+
+    OS_vLock();
+    if (TIMER_eGetState(timer_id->tTimer) == E_TIMER_STATE_RUNNING &&
+        TIMER_eStop(timer_id->tTimer) == E_TIMER_OK)
+    {
+        eStatus = osOK;
+    }
+    OS_vUnlock();
+
+    return eStatus;
+}
+
+osStatus osTimerDelete(osTimerId timer_id)
+{
+    if (PORTABLE_bOsInIsr())
+    {
+        return osErrorISR;
+    }
+    if (timer_id == NULL || !timer_id->bCreated)
+    {
+        return osErrorParameter;
+    }
+
+    OS_vLock();
+    (void)TIMER_eClose(timer_id->tTimer);
+    timer_id->bCreated = FALSE;
+    OS_vUnlock();
+
+    return osOK;
+}
+
+/***  Semaphores  ***/
+
+osSemaphoreId osSemaphoreCreate(const osSemaphoreDef_t *semaphore_def, int32_t count)
+{
+    if (semaphore_def == NULL || count < 0 || count > osFeature_Semaphore || PORTABLE_bOsInIsr())
+    {
+        return NULL;
+    }
+
+    semaphore_def->cb->i32Count = count;
+    semaphore_def->cb->bCreated = TRUE;
+
+    return semaphore_def->cb;
+}
+
+/* Takes a token. Returns the tokens there were before, at least 1, or 0 when
+ * none came within millisec and -1 for a bad or deleted semaphore. */
+int32_t osSemaphoreWait(osSemaphoreId semaphore_id, uint32_t millisec)
+{
+    int32_t i32Tokens;
+    osStatus eResult;
+    uint8 u8State;
+
+    if (semaphore_id == NULL || !semaphore_id->bCreated)
+    {
+        return -1;
+    }
+
+    u8State = PORTABLE_u8EnterCritical();
+    if (semaphore_id->i32Count > 0)
+    {
+        i32Tokens = semaphore_id->i32Count--;
+    }
+    else if (millisec == 0 || !OS_bCanWait())
+    {
+        i32Tokens = 0;
+    }
+    else
+    {
+        /* A release hands its token straight to the waiting thread */
+        eResult = OS_eWait(OS_WAIT_SEMAPHORE, semaphore_id, millisec, &u8State);
+        i32Tokens = (eResult == osOK) ? 1 : ((eResult == osEventTimeout) ? 0 : -1);
+    }
+    PORTABLE_vExitCritical(u8State);
+
+    return i32Tokens;
+}
+
+/* May be called from an ISR */
+osStatus osSemaphoreRelease(osSemaphoreId semaphore_id)
+{
+    osStatus eStatus = osOK;
+    uint8 u8State;
+
+    if (semaphore_id == NULL || !semaphore_id->bCreated)
+    {
+        return osErrorParameter;
+    }
+
+    u8State = PORTABLE_u8EnterCritical();
+    if (OS_psWake(OS_WAIT_SEMAPHORE, semaphore_id, osOK) != NULL)
+    {
+        OS_vReschedule(FALSE);
+    }
+    else if (semaphore_id->i32Count < osFeature_Semaphore)
+    {
+        semaphore_id->i32Count++;
+    }
+    else
+    {
+        eStatus = osErrorResource;
+    }
+    PORTABLE_vExitCritical(u8State);
+
+    return eStatus;
+}
+
+/* Threads still waiting get -1 from osSemaphoreWait */
+osStatus osSemaphoreDelete(osSemaphoreId semaphore_id)
+{
+    uint8 u8State;
+
+    if (PORTABLE_bOsInIsr())
+    {
+        return osErrorISR;
+    }
+    if (semaphore_id == NULL || !semaphore_id->bCreated)
+    {
+        return osErrorParameter;
+    }
+
+    u8State = PORTABLE_u8EnterCritical();
+    semaphore_id->bCreated = FALSE;
+    while (OS_psWake(OS_WAIT_SEMAPHORE, semaphore_id, osErrorResource) != NULL)
+    {
+    }
+    OS_vReschedule(FALSE);
+    PORTABLE_vExitCritical(u8State);
+
+    return osOK;
+}
+
+/***  Message queues  ***/
+
+/* The messages are held in a tsQueue on the pool of queue_def. thread_id is
+ * not used. */
+osMessageQId osMessageCreate(const osMessageQDef_t *queue_def, osThreadId thread_id)
+{
+    (void)thread_id;
+
+    if (queue_def == NULL || queue_def->queue_sz == 0 || PORTABLE_bOsInIsr())
+    {
+        return NULL;
+    }
+
+    /* Created again: the messages still queued are dropped */
+    if (queue_def->cb->bCreated)
+    {
+        QUEUE_vFlush(&queue_def->cb->sQueue);
+    }
+    QUEUE_vCreate(&queue_def->cb->sQueue, queue_def->queue_sz, sizeof(uint32_t), (uint8 *)queue_def->pool);
+    queue_def->cb->bCreated = TRUE;
+
+    return queue_def->cb;
+}
+
+/* A thread waiting in osMessageGet is given info directly; otherwise it is
+ * queued, waiting up to millisec for room. From an ISR millisec must be 0. */
+osStatus osMessagePut(osMessageQId queue_id, uint32_t info, uint32_t millisec)
+{
+    struct os_thread_cb *psThread;
+    osStatus eStatus;
+    uint8 u8State;
+
+    if (queue_id == NULL || !queue_id->bCreated)
+    {
+        return osErrorParameter;
+    }
+
+    u8State = PORTABLE_u8EnterCritical();
+    for (;;)
+    {
+        psThread = OS_psWake(OS_WAIT_MESSAGE, queue_id, osEventMessage);
+        if (psThread != NULL)
+        {
+            psThread->u32Message = info;
+            OS_vReschedule(FALSE);
+            eStatus = osOK;
+            break;
+        }
+        if (QUEUE_bSend(&queue_id->sQueue, &info))
+        {
+            eStatus = osOK;
+            break;
+        }
+        if (millisec == 0 || !OS_bCanWait())
+        {
+            eStatus = osErrorResource;
+            break;
+        }
+
+        /* Woken by a get, the room may be taken again before this thread
+           runs: try again with what is left of the timeout */
+        eStatus = OS_eWait(OS_WAIT_SPACE, queue_id, millisec, &u8State);
+        if (eStatus != osOK)
+        {
+            eStatus = (eStatus == osEventTimeout) ? osErrorTimeoutResource : eStatus;
+            break;
+        }
+        millisec = OS_psCurrent->u32Timeout;
+    }
+    PORTABLE_vExitCritical(u8State);
+
+    return eStatus;
+}
+
+/* status is osEventMessage with the message in value.v, osOK when the queue is
+ * empty and millisec 0, osEventTimeout when nothing came in time */
+osEvent osMessageGet(osMessageQId queue_id, uint32_t millisec)
+{
+    osEvent sEvent;
+    uint8 u8State;
+
+    sEvent.value.v = 0;
+    sEvent.def.message_id = queue_id;
+
+    if (queue_id == NULL || !queue_id->bCreated)
+    {
+        sEvent.status = osErrorParameter;
+        return sEvent;
+    }
+
+    u8State = PORTABLE_u8EnterCritical();
+    if (QUEUE_bReceive(&queue_id->sQueue, &sEvent.value.v))
+    {
+        sEvent.status = osEventMessage;
+        if (OS_psWake(OS_WAIT_SPACE, queue_id, osOK) != NULL)
+        {
+            OS_vReschedule(FALSE);
+        }
+    }
+    else if (millisec == 0 || !OS_bCanWait())
+    {
+        sEvent.status = osOK;
+    }
+    else
+    {
+        sEvent.status = OS_eWait(OS_WAIT_MESSAGE, queue_id, millisec, &u8State);
+        if (sEvent.status == osEventMessage)
+        {
+            sEvent.value.v = OS_psCurrent->u32Message;
+        }
+    }
+    PORTABLE_vExitCritical(u8State);
+
+    return sEvent;
+}
+
+/****************************************************************************/
+/***        Local Functions                                               ***/
+/****************************************************************************/
+
+/* Creates the idle and timer threads once, before the first thread */
+static void OS_vInit(void)
+{
+    if (OS_sCommon.bInitialised)
+    {
+        return;
+    }
+
+    memset(&OS_sCommon, 0, sizeof(OS_tsCommon));
+    OS_psCurrent = NULL;
+    OS_psNext = NULL;
+    OS_sCommon.bInitialised = TRUE;
+
+    (void)OS_bThreadInit(&OS_sIdleThread, OS_vIdleThread, NULL, OS_IDLE_PRIORITY,
+                         OS_au32IdleStack, OS_STACK_WORDS(OS_IDLE_STACK_SIZE));
+    (void)OS_bThreadInit(&OS_sTimerThread, OS_vTimerThread, NULL, (int8_t)OS_TIMER_PRIORITY,
+                         OS_au32TimerStack, OS_STACK_WORDS(OS_TIMER_STACK_SIZE));
+}
+
+/* Makes psThread ready, taking a table slot the first time the control block
+ * is used. Called with interrupts disabled or before the kernel runs. */
+static bool_t OS_bThreadInit(struct os_thread_cb *psThread, os_pthread pfThread, void *pvArgument,
+                             int8_t i8Priority, uint32 *pu32Stack, uint32 u32StackWords)
+{
+    uint8 u8Slot;
+
+    for (u8Slot = 0; u8Slot < OS_sCommon.u8NumThreads; u8Slot++)
+    {
+        if (OS_sCommon.apsThreads[u8Slot] == psThread)
+        {
+            break;
+        }
+    }
+    if (u8Slot == OS_sCommon.u8NumThreads)
+    {
+        if (u8Slot == OS_MAX_THREADS)
+        {
+            return FALSE;
+        }
+        OS_sCommon.apsThreads[u8Slot] = psThread;
+        OS_sCommon.u8NumThreads++;
+    }
+
+    psThread->pfThread = pfThread;
+    psThread->pvArgument = pvArgument;
+    psThread->pu32Stack = pu32Stack;
+    psThread->u32StackWords = u32StackWords;
+    psThread->i8Priority = i8Priority;
+    psThread->u8Slot = u8Slot;
+    psThread->pvWaitObject = NULL;
+    PORTABLE_vOsInitThread(psThread);
+    psThread->u8State = OS_STATE_READY;
+
+    return TRUE;
+}
+
+/* Picks the highest priority ready thread into OS_psNext and has the port
+ * switch to it. bRotate looks at the running thread last, so that the next
+ * one of the same priority gets its turn; otherwise it is kept. */
+static void OS_vReschedule(bool_t bRotate)
+{
+    struct os_thread_cb *psBest = NULL;
+    struct os_thread_cb *psThread;
+    uint8 u8Start = 0;
+    uint8 u8Count;
+    uint8 u8Slot;
+
+    if (!OS_sCommon.bRunning)
+    {
+        return;
+    }
+    /* Locked, the running thread keeps the CPU unless it stopped being ready */
+    if (OS_sCommon.u8Lock != 0 && OS_psCurrent != NULL && OS_psCurrent->u8State == OS_STATE_READY)
+    {
+        return;
+    }
+
+    if (OS_psCurrent != NULL)
+    {
+        u8Start = (uint8)(OS_psCurrent->u8Slot + (bRotate ? 1 : 0));
+    }
+
+    for (u8Count = 0; u8Count < OS_sCommon.u8NumThreads; u8Count++)
+    {
+        u8Slot = (uint8)((u8Start + u8Count) % OS_sCommon.u8NumThreads);
+        psThread = OS_sCommon.apsThreads[u8Slot];
+        if (psThread->u8State == OS_STATE_READY &&
+            (psBest == NULL || psThread->i8Priority > psBest->i8Priority))
+        {
+            psBest = psThread;
+        }
+    }
+
+    /* The idle thread is always ready */
+    OS_psNext = psBest;
+    if (OS_psCurrent != NULL && psBest != OS_psCurrent)
+    {
+        PORTABLE_vOsSwitch();
+    }
+}
+
+/* Puts the running thread to wait and switches away. Called in a critical
+ * section whose state is at *pu8State: the section is left for the switch
+ * and entered again once the thread runs, with the reason the wait ended. */
+static osStatus OS_eWait(uint8 u8Wait, const void *pvObject, uint32 u32Millisec, uint8 *pu8State)
+{
+    struct os_thread_cb *psThread = OS_psCurrent;
+
+    psThread->u8State = OS_STATE_WAITING;
+    psThread->u8Wait = u8Wait;
+    psThread->pvWaitObject = pvObject;
+    psThread->u32Timeout = u32Millisec;
+    psThread->eWaitResult = osEventTimeout;
+    OS_vReschedule(FALSE);
+
+    PORTABLE_vExitCritical(*pu8State);
+    *pu8State = PORTABLE_u8EnterCritical();
+
+    psThread->pvWaitObject = NULL;
+    return psThread->eWaitResult;
+}
+
+/* Readies the highest priority thread waiting for u8Wait on pvObject, the
+ * caller reschedules */
+static struct os_thread_cb *OS_psWake(uint8 u8Wait, const void *pvObject, osStatus eResult)
+{
+    struct os_thread_cb *psBest = NULL;
+    struct os_thread_cb *psThread;
+    uint8 u8Slot;
+
+    for (u8Slot = 0; u8Slot < OS_sCommon.u8NumThreads; u8Slot++)
+    {
+        psThread = OS_sCommon.apsThreads[u8Slot];
+        if (psThread->u8State == OS_STATE_WAITING && psThread->u8Wait == u8Wait &&
+            psThread->pvWaitObject == pvObject &&
+            (psBest == NULL || psThread->i8Priority > psBest->i8Priority))
+        {
+            psBest = psThread;
+        }
+    }
+
+    if (psBest != NULL)
+    {
+        psBest->u8State = OS_STATE_READY;
+        psBest->eWaitResult = eResult;
+    }
+    return psBest;
+}
+
+/* Neither an ISR nor the timer thread with the scheduler locked can wait */
+static bool_t OS_bCanWait(void)
+{
+    return (bool_t)(OS_sCommon.bRunning && OS_sCommon.u8Lock == 0 && !PORTABLE_bOsInIsr());
+}
+
+/* Keeps the running thread on the CPU, interrupts still run. Guards the
+ * TIMER_* calls, which are not reentrant. */
+static void OS_vLock(void)
+{
+    uint8 u8State = PORTABLE_u8EnterCritical();
+
+    OS_sCommon.u8Lock++;
+    PORTABLE_vExitCritical(u8State);
+}
+
+static void OS_vUnlock(void)
+{
+    uint8 u8State = PORTABLE_u8EnterCritical();
+
+    if (--OS_sCommon.u8Lock == 0)
+    {
+        OS_vReschedule(FALSE);
+    }
+    PORTABLE_vExitCritical(u8State);
+}
+
+static void OS_vIdleThread(void const *pvArgument)
+{
+    (void)pvArgument;
+
+    for (;;)
+    {
+        PORTABLE_vOsIdle();
+    }
+}
+
+/* Runs the expired TIMER_* timers whenever OS_vTick finds a tick pending */
+static void OS_vTimerThread(void const *pvArgument)
+{
+    uint8 u8State;
+
+    (void)pvArgument;
+
+    for (;;)
+    {
+        u8State = PORTABLE_u8EnterCritical();
+        if (!TIMER_bIsTickPending())
+        {
+            (void)OS_eWait(OS_WAIT_TIMER, NULL, osWaitForever, &u8State);
+        }
+        PORTABLE_vExitCritical(u8State);
+
+        OS_vLock();
+        TIMER_vTask();
+        OS_vUnlock();
+    }
+}
+
+static void OS_vTimerCallback(void *pvParam)
+{
+    struct os_timer_cb *psTimer = (struct os_timer_cb *)pvParam;
+
+    psTimer->pfCallback(psTimer->pvArgument);
+}
+
+#endif /* PORTABLE_SUPPORT_RTOS */
+
+/****************************************************************************/
+/***        END OF FILE                                                   ***/
+/****************************************************************************/
@@ -31,6 +31,7 @@
 #include "serial.h"
 #include <string.h>
 #include "Queue.h"
+#include "PowerManager.h"
 
 #ifdef SERIAL_TOTAL_NUMBER
 /****************************************************************************/
@@ -44,6 +45,7 @@
 /****************************************************************************/
 /***        Local Function Prototypes                                     ***/
 /****************************************************************************/
+static void SERIAL_vSending(uint8 u8SerialIndex, bool_t bSending);
 
 /****************************************************************************/
 /***        Exported Variables                                            ***/
@@ -57,6 +59,9 @@
 /***        Local Variables                                               ***/
 /****************************************************************************/
 static SERIAL_tsSerial asSerial[SERIAL_TOTAL_NUMBER];
+/* A transmission holds a driver activity of the power manager, the UART
+   needs its clock until the interrupt finds the TX queue empty */
+static bool_t abSending[SERIAL_TOTAL_NUMBER];
 
 tsQueue SERIAL_msgTx[SERIAL_TOTAL_NUMBER];
 tsQueue SERIAL_msgRx[SERIAL_TOTAL_NUMBER];
@@ -96,6 +101,10 @@ SERIAL_teStatus SERIAL_eOpen(uint8 *pu8SerialIndex, SERIAL_tsSerial *psSerial)
                 /* create queue save buffer */
                 QUEUE_vCreate(&SERIAL_msgTx[i], SERIAL_TX_QUEUE_SIZE, sizeof(uint8), (uint8*)&au8SerialBufTx[i][0]);
                 QUEUE_vCreate(&SERIAL_msgRx[i], SERIAL_RX_QUEUE_SIZE, sizeof(uint8), (uint8*)&au8SerialBufRx[i][0]);
+                #ifdef QUEUE_SUPPORT_STATISTICS
+                QUEUE_vSetName(&SERIAL_msgTx[i], "SERIAL_TX");
+                QUEUE_vSetName(&SERIAL_msgRx[i], "SERIAL_RX");
+                #endif
 
                 return E_SERIAL_OK;
             }
@@ -117,6 +126,10 @@ SERIAL_teStatus SERIAL_eClose(uint8 u8SerialIndex)
 
     /* release hardware serial */
     psSerials->pfClose();
+    SERIAL_vSending(u8SerialIndex, FALSE);
+    /* bytes left over are dropped, they no longer keep the part awake */
+    QUEUE_vFlush(&SERIAL_msgTx[u8SerialIndex]);
+    QUEUE_vFlush(&SERIAL_msgRx[u8SerialIndex]);
     /* reset all method of serial */
     memset(psSerials, 0, sizeof(SERIAL_tsSerial));
 
@@ -186,6 +199,7 @@ SERIAL_teStatus SERIAL_eGet(uint8 u8SerialIndex, uint8 *pu8Byte)
     {
         /* call function stop send */
         asSerial[u8SerialIndex].pfStopSend();
+        SERIAL_vSending(u8SerialIndex, FALSE);
 
         return E_SERIAL_FAIL;
     }
@@ -211,16 +225,14 @@ SERIAL_teStatus SERIAL_eWrite(uint8 u8SerialIndex, uint8 *pau8Byte)
         return E_SERIAL_FAIL;
     }
 
-    uint8 i;
-    for ( i = 0; i < strlen((char*)pau8Byte); i++)
+    uint32 u32Length = strlen((char*)pau8Byte);
+    if (QUEUE_u32SendMany(&SERIAL_msgTx[u8SerialIndex], pau8Byte, u32Length) != u32Length)
     {
-        if (!QUEUE_bSend(&SERIAL_msgTx[u8SerialIndex], &pau8Byte[i]))
-        {
-            return E_SERIAL_FAIL;
-        }
+        return E_SERIAL_FAIL;
     }
 
     /* call function start send */
+    SERIAL_vSending(u8SerialIndex, TRUE);
     asSerial[u8SerialIndex].pfStartSend();
     
     return E_SERIAL_OK;
@@ -228,25 +240,55 @@ SERIAL_teStatus SERIAL_eWrite(uint8 u8SerialIndex, uint8 *pau8Byte)
 
 uint32 SERIAL_u32Read(uint8 u8SerialIndex, uint8 *pau8Byte)
 {
-    int i;
-    /* loop until queue empty */
-    while (!QUEUE_bIsEmpty(&SERIAL_msgRx[u8SerialIndex]))
-    {
-        if (!QUEUE_bReceive(&SERIAL_msgRx[u8SerialIndex], &pau8Byte[i]))
-        {
-            break;
-        }
+    /* read everything until queue empty */
+    return QUEUE_u32ReceiveMany(&SERIAL_msgRx[u8SerialIndex], pau8Byte,
+                                QUEUE_u32GetQueueMessageWaiting(&SERIAL_msgRx[u8SerialIndex]));
+}
+
+/* The RX interrupt only reads the data register and posts the byte here */
+void SERIAL_vDeferPut(void *pvSerialIndex, uint16 u16Byte)
+{
+    (void)SERIAL_ePut(*(uint8 *)pvSerialIndex, (uint8)u16Byte);
+}
+
+/* The TX interrupt only masks itself and posts this: the next byte is sent and
+   the interrupt enabled again, or sending stops when the queue is empty */
+void SERIAL_vDeferSend(void *pvSerialIndex, uint16 u16Unused)
+{
+    uint8 u8SerialIndex = *(uint8 *)pvSerialIndex;
+    uint8 u8Byte;
+
+    (void)u16Unused;
 
-        /* next item */
-        i++;
+    if (SERIAL_eGet(u8SerialIndex, &u8Byte) == E_SERIAL_OK)
+    {
+        SERIAL_vSend(u8SerialIndex, u8Byte);
+        asSerial[u8SerialIndex].pfStartSend();
     }
-    
-    return i;
 }
 
 /****************************************************************************/
 /***        Local Function                                                ***/
 /****************************************************************************/
+static void SERIAL_vSending(uint8 u8SerialIndex, bool_t bSending)
+{
+    uint8 u8State = PORTABLE_u8EnterCritical();
+
+    if (abSending[u8SerialIndex] != bSending)
+    {
+        abSending[u8SerialIndex] = bSending;
+        if (bSending)
+        {
+            PWRM_vStartActivity(E_PWRM_ACTIVITY_DRIVER);
+        }
+        else
+        {
+            PWRM_vFinishActivity(E_PWRM_ACTIVITY_DRIVER);
+        }
+    }
+
+    PORTABLE_vExitCritical(u8State);
+}
 
 #endif /*SERIAL_TOTAL_NUMBER*/
 /****************************************************************************/
@@ -40,6 +40,12 @@
 #define SERIAL_RX_QUEUE_SIZE    150
 #endif
 
+/* Deferred work level (Defer.h) the UART interrupt handlers of each part post
+   their bytes to */
+#ifndef SERIAL_DEFER_LEVEL
+#define SERIAL_DEFER_LEVEL      (0)
+#endif
+
 /* Exported Typedefs ---------------------------------------------------------*/
 typedef void (*SERIAL_ptfOpen)(void);
 typedef void (*SERIAL_ptfClose)(void);
@@ -83,6 +89,9 @@ SERIAL_teStatus SERIAL_ePut(uint8 u8SerialIndex, uint8 u8Byte);
 SERIAL_teStatus SERIAL_eWrite(uint8 u8SerialIndex, uint8 *pau8Byte);
 uint32 SERIAL_u32Read(uint8 u8SerialIndex, uint8 *pau8Byte);
 SERIAL_teStatus SERIAL_eFlush(uint8 u8SerialIndex);
+/* Deferred interrupt work (DEFER_tpfWork), pvSerialIndex points to the index */
+void SERIAL_vDeferPut(void *pvSerialIndex, uint16 u16Byte);
+void SERIAL_vDeferSend(void *pvSerialIndex, uint16 u16Unused);
 /* External Variable Declarations --------------------------------------------*/
 
 #ifdef __cplusplus
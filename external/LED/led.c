@@ -66,7 +66,7 @@ static LED_tsLed asLeds[LED_TOTAL_NUMBER];
 
 #ifdef LED_SUPPORT_EFFECT
 static LED_tsEffect LED_asEffect[LED_TOTAL_NUMBER];
-uint8 u8TimerTickLED;
+TIMER_tHandle tTimerTickLED;
 #endif
 /****************************************************************************/
 /***        Exported Functions                                            ***/
@@ -76,8 +76,8 @@ LED_teStatus LED_eInit(void)
     memset(asLeds, 0, sizeof(LED_tsLed) * LED_TOTAL_NUMBER);
 
     #ifdef LED_SUPPORT_EFFECT
-    TIMER_eOpen(&u8TimerTickLED, LED_vIdEffectTick, NULL, TIMER_FLAG_PREVENT_SLEEP);
-    TIMER_eStart(u8TimerTickLED, LED_TIME_TICK);
+    TIMER_eOpen(&tTimerTickLED, LED_vIdEffectTick, NULL, TIMER_FLAG_PREVENT_SLEEP | TIMER_FLAG_PERIODIC);
+    TIMER_eStart(tTimerTickLED, LED_TIME_TICK);
     #endif
 
     return E_LED_OK;
@@ -291,9 +291,6 @@ LED_teStatus LED_eStartEffect(uint8 u8LedIndex, LED_tsEffect *psEffect)
 
 static void LED_vIdEffectTick(void *pvParam)
 {
-    /* restart timer */
-    TIMER_eStart(u8TimerTickLED, LED_TIME_TICK);
-
     /* handle tick LED */
     int i;
     LED_tsEffect    *psEffect;
@@ -32,12 +32,13 @@
 /* Private Structure Definition ----------------------------------------------*/
 /* Global Variables ----------------------------------------------------------*/
 tsQueue           APP_msgButtonEvents;
-uint8 u8TimerScanButtons;
+TIMER_tHandle tTimerScanButtons;
 /* Private Variables Declarations --------------------------------------------*/
 static BUTTON_tsButton  asButtons[BUTTON_TOTAL_NUMBER];
 static BUTTON_tsEvent    asButtonMsg [BUTTON_QUEUE_SIZE];
 
 static void BUTTON_vScanTask(void *pvParam);
+static void BUTTON_vPostEvent(BUTTON_teState eState, uint8 u8NumberIndex, uint8 u8Click);
 
 
 BUTTON_teStatus BUTTON_eInit(void)
@@ -46,10 +47,13 @@ BUTTON_teStatus BUTTON_eInit(void)
 
         /* Create queue for result of button */
         QUEUE_vCreate( &APP_msgButtonEvents, BUTTON_QUEUE_SIZE, sizeof(BUTTON_tsEvent), (uint8*)asButtonMsg);
+        #ifdef QUEUE_SUPPORT_STATISTICS
+        QUEUE_vSetName(&APP_msgButtonEvents, "BUTTON");
+        #endif
 	
 	/* Create timer for scan button */
-	TIMER_eOpen(&u8TimerScanButtons, BUTTON_vScanTask, NULL, TIMER_FLAG_PREVENT_SLEEP);
-	TIMER_eStart(u8TimerScanButtons, BUTTON_TIME_SCAN);
+	TIMER_eOpen(&tTimerScanButtons, BUTTON_vScanTask, NULL, TIMER_FLAG_PREVENT_SLEEP | TIMER_FLAG_PERIODIC);
+	TIMER_eStart(tTimerScanButtons, BUTTON_TIME_SCAN);
 	
 	return E_BUTTON_OK;
 }
@@ -112,9 +116,6 @@ BUTTON_teStatus BUTTON_eClose(uint8 u8ButtonIndex)
 
 static void BUTTON_vScanTask(void *pvParam)
 {
-	/* restart timer scan button */
-	TIMER_eStart(u8TimerScanButtons, BUTTON_TIME_SCAN);
-	
 	/* scan button */
         int i;
         BUTTON_tsButton *psButtons;
@@ -145,10 +146,7 @@ static void BUTTON_vScanTask(void *pvParam)
                                                         psButtons->timerSampleRL = 0;
                                                         psButtons->timePress = 0;                               /* reset time press */
                                                         /* send to queue button with state release */
-                                                        BUTTON_tsEvent sButtonEvent;
-                                                        sButtonEvent.eState = E_BUTTON_STATE_RELEASE;
-                                                        sButtonEvent.u8NumberIndex = i;
-                                                        QUEUE_bSend(&APP_msgButtonEvents, &sButtonEvent);
+                                                        BUTTON_vPostEvent(E_BUTTON_STATE_RELEASE, i, 0);
                                                 }
                                         }
                                         
@@ -196,10 +194,7 @@ static void BUTTON_vScanTask(void *pvParam)
                                                 psButtons->flagSampleResult = BUTTON_DISABLE_SAMPLE;            /* Disable sample result */
                                                 psButtons->countClick = 0;                                      /* reset count click */
                                                 /* send queue button with state hold on */
-                                                BUTTON_tsEvent sButtonEvent;
-                                                sButtonEvent.eState = E_BUTTON_STATE_HOLD_ON;
-                                                sButtonEvent.u8NumberIndex = i;
-                                                QUEUE_bSend(&APP_msgButtonEvents, &sButtonEvent);
+                                                BUTTON_vPostEvent(E_BUTTON_STATE_HOLD_ON, i, 0);
                                         }
                                 }
                                 else
@@ -239,11 +234,7 @@ static void BUTTON_vScanTask(void *pvParam)
                                         if (psButtons->timePress <= BUTTON_TIME_CLICK)                          /* just update when not hold_on */
                                         {
                                                 /* send to queue button with value psButtons->countClick */
-                                                BUTTON_tsEvent sButtonEvent;
-                                                sButtonEvent.eState = E_BUTTON_STATE_PRESS;
-                                                sButtonEvent.u8NumberIndex = i;
-                                                sButtonEvent.u8Click = psButtons->countClick;
-                                                QUEUE_bSend(&APP_msgButtonEvents, &sButtonEvent);
+                                                BUTTON_vPostEvent(E_BUTTON_STATE_PRESS, i, psButtons->countClick);
                                                 psButtons->countClick = 0;                                      /* reset count click */
                                         }
                                         
@@ -258,6 +249,20 @@ static void BUTTON_vScanTask(void *pvParam)
         }
 }
 
+static void BUTTON_vPostEvent(BUTTON_teState eState, uint8 u8NumberIndex, uint8 u8Click)
+{
+        /* build the event directly in the queue slot */
+        BUTTON_tsEvent *psButtonEvent = (BUTTON_tsEvent *)QUEUE_pvReserve(&APP_msgButtonEvents);
+
+        if (psButtonEvent != NULL)
+        {
+                psButtonEvent->eState = eState;
+                psButtonEvent->u8NumberIndex = u8NumberIndex;
+                psButtonEvent->u8Click = u8Click;
+                QUEUE_vCommit(&APP_msgButtonEvents);
+        }
+}
+
 BUTTON_teStatus BUTTON_eStop(void)
 {
         /* check queue result */
@@ -274,13 +279,13 @@ BUTTON_teStatus BUTTON_eStop(void)
         }
         
         /* stop timer scan button */
-        TIMER_eStop(u8TimerScanButtons);
+        TIMER_eStop(tTimerScanButtons);
         return E_BUTTON_OK;
 }
 
 BUTTON_teStatus BUTTON_eRestart(void)
 {
-        TIMER_eStart(u8TimerScanButtons, BUTTON_TIME_SCAN);
+        TIMER_eStart(tTimerScanButtons, BUTTON_TIME_SCAN);
         return E_BUTTON_OK;
 }
 
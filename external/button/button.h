@@ -31,6 +31,7 @@
 #include "chip_selection.h"
 #include <stdbool.h>
 #include "Queue.h"
+#include "Timer.h"
 #include "prj_options.h"
 /* Exported Define -----------------------------------------------------------*/
 
@@ -125,7 +126,7 @@ BUTTON_teStatus BUTTON_eRestart(void);
 /* External Variable Declarations --------------------------------------------*/
 #ifdef BUTTON_TOTAL_NUMBER
 extern tsQueue           APP_msgButtonEvents;
-extern uint8 u8TimerScanButtons;
+extern TIMER_tHandle tTimerScanButtons;
 #endif
 #ifdef __cplusplus
 }
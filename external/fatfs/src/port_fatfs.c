@@ -20,6 +20,7 @@
 #include "chip_selection.h"
 #include "prj_options.h"
 #include "port_fatfs.h"
+#include "Coroutine.h"
 
 /* MMC/SD command */
 #define CMD0	(0)			/* GO_IDLE_STATE */
@@ -97,21 +98,32 @@ void xmit_spi_multi (
 /* Wait for card ready                                                   */
 /*-----------------------------------------------------------------------*/
 
+static
+CO_teStatus wait_ready_co (	/* Coroutine, *rdy 1:Ready, 0:Timeout */
+	CO_tsState *co,
+	UINT wt,		/* Timeout [ms] */
+	int *rdy
+)
+{
+  CO_BEGIN(co);
+  Timer2 = wt;
+  /* Wait for card goes ready or timeout, other work runs while it is busy */
+  CO_WAIT_UNTIL(co, (*rdy = (SPI_u8ExchangeByte(u8FATfsIndex, 0xFF) == 0xFF)) || !Timer2);
+  CO_END(co);
+}
+
 static
 int wait_ready (	/* 1:Ready, 0:Timeout */
 	UINT wt			/* Timeout [ms] */
 )
 {
-  BYTE d;
+  CO_tsState co;
+  int rdy;
   
   
-  Timer2 = wt;
-  do {
-    d = SPI_u8ExchangeByte(u8FATfsIndex, 0xFF);
-    /* This loop takes a time. Insert rot_rdq() here for multitask envilonment. */
-  } while (d != 0xFF && Timer2);	/* Wait for card goes ready or timeout */
+  CO_BLOCK(&co, wait_ready_co(&co, wt, &rdy));
   
-  return (d == 0xFF) ? 1 : 0;
+  return rdy;
 }
 
 /*-----------------------------------------------------------------------*/
@@ -145,20 +157,30 @@ int select (void)	/* 1:OK, 0:Timeout */
 /* Receive a data packet from the MMC                                    */
 /*-----------------------------------------------------------------------*/
 
+static
+CO_teStatus wait_token_co (	/* Coroutine, *token: DataStart token, 0xFF on timeout */
+	CO_tsState *co,
+	BYTE *token
+)
+{
+  CO_BEGIN(co);
+  Timer1 = 200;
+  /* Wait for DataStart token in timeout of 200ms, other work runs meanwhile */
+  CO_WAIT_UNTIL(co, ((*token = SPI_u8ExchangeByte(u8FATfsIndex, 0xFF)) != 0xFF) || !Timer1);
+  CO_END(co);
+}
+
 static
 int rcvr_datablock (	/* 1:OK, 0:Error */
 	BYTE *buff,			/* Data buffer */
 	UINT btr			/* Data block length (byte) */
 )
 {
+  CO_tsState co;
   BYTE token;
   
   
-  Timer1 = 200;
-  do {							/* Wait for DataStart token in timeout of 200ms */
-    token = SPI_u8ExchangeByte(u8FATfsIndex, 0xFF);
-    /* This loop will take a time. Insert rot_rdq() here for multitask envilonment. */
-  } while ((token == 0xFF) && Timer1);
+  CO_BLOCK(&co, wait_token_co(&co, &token));
   if(token != 0xFE) return 0;		/* Function fails if invalid DataStart token or timeout */
   
   rcvr_spi_multi(buff, btr);		/* Store trailing data to the buffer */
@@ -270,7 +292,7 @@ DSTATUS disk_initialize (
     if (send_cmd(CMD8, 0x1AA) == 1) {	/* SDv2? */
       for (n = 0; n < 4; n++) ocr[n] = SPI_u8ExchangeByte(u8FATfsIndex,0xFF);	/* Get 32 bit return value of R7 resp */
       if (ocr[2] == 0x01 && ocr[3] == 0xAA) {				/* Is the card supports vcc of 2.7-3.6V? */
-        while (Timer1 && send_cmd(ACMD41, 1UL << 30)) ;	/* Wait for end of initialization with ACMD41(HCS) */
+        while (Timer1 && send_cmd(ACMD41, 1UL << 30)) CO_vIdle();	/* Wait for end of initialization with ACMD41(HCS) */
         if (Timer1 && send_cmd(CMD58, 0) == 0) {		/* Check CCS bit in the OCR */
           for (n = 0; n < 4; n++) ocr[n] = SPI_u8ExchangeByte(u8FATfsIndex,0xFF);
           ty = (ocr[0] & 0x40) ? CT_SD2 | CT_BLOCK : CT_SD2;	/* Card id SDv2 */
@@ -282,7 +304,7 @@ DSTATUS disk_initialize (
       } else {
         ty = CT_MMC; cmd = CMD1;	/* MMCv3 (CMD1(0)) */
       }
-      while (Timer1 && send_cmd(cmd, 0)) ;		/* Wait for end of initialization */
+      while (Timer1 && send_cmd(cmd, 0)) CO_vIdle();		/* Wait for end of initialization */
       if (!Timer1 || send_cmd(CMD16, 512) != 0)	/* Set block length: 512 */
         ty = 0;
     }
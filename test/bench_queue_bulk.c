@@ -0,0 +1,156 @@
+/****************************************************************************
+ *
+ * MODULE:    bench_queue_bulk.c
+ *
+ * DESCRIPTION:
+ * Host benchmark of QUEUE_u32SendMany / QUEUE_u32ReceiveMany against a loop of
+ * QUEUE_bSend / QUEUE_bReceive, for 1, 4 and 16 byte items. Batches are sized
+ * so that about half of them cross the wrap point of the ring.
+ *
+ ****************************************************************************
+ *
+ * This software is owned by NXP B.V. and/or its supplier and is protected
+ * under applicable copyright laws. All rights are reserved. We grant You,
+ * and any third parties, a license to use this software solely and
+ * exclusively on NXP products [NXP Microcontrollers such as JN5168, JN5179].
+ * You, and any third parties must reproduce the copyright and warranty notice
+ * and any other legend of ownership on each copy or partial copy of the
+ * software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Copyright NXP B.V. 2016. All rights reserved
+ *
+ ***************************************************************************/
+
+/****************************************************************************/
+/***        Include files                                                 ***/
+/****************************************************************************/
+
+#include "Queue.h"
+#include "test.h"
+
+/****************************************************************************/
+/***        Macro Definitions                                             ***/
+/****************************************************************************/
+
+#define BENCH_QUEUE_LENGTH      (128)
+#define BENCH_BATCH             (48)
+#define BENCH_NUM_ITEMS         (8000000UL)
+#define BENCH_MAX_ITEM_SIZE     (16)
+
+/****************************************************************************/
+/***        Local Function Prototypes                                     ***/
+/****************************************************************************/
+
+static uint64 bench_per_item(uint32 u32ItemSize);
+static uint64 bench_bulk(uint32 u32ItemSize);
+
+/****************************************************************************/
+/***        Local Variables                                               ***/
+/****************************************************************************/
+
+static uint8 au8Storage[BENCH_QUEUE_LENGTH * BENCH_MAX_ITEM_SIZE];
+static uint8 au8In[BENCH_BATCH * BENCH_MAX_ITEM_SIZE];
+static uint8 au8Out[BENCH_BATCH * BENCH_MAX_ITEM_SIZE];
+static volatile uint32 u32Sink;         /* Keeps the copies from being optimised out */
+
+/****************************************************************************/
+/***        Exported Functions                                            ***/
+/****************************************************************************/
+
+int main(void)
+{
+    static const uint32 au32Sizes[] = { 1, 4, 16 };
+    uint64 u64PerItem;
+    uint64 u64Bulk;
+    uint32 n;
+
+    for (n = 0; n < sizeof(au8In); n++)
+    {
+        au8In[n] = (uint8)n;
+    }
+
+    printf("bench_queue_bulk: %lu items, batches of %u, queue of %u\n",
+           (unsigned long)BENCH_NUM_ITEMS, BENCH_BATCH, BENCH_QUEUE_LENGTH);
+    printf("item size   per item ns/item   bulk ns/item   speed-up\n");
+
+    for (n = 0; n < sizeof(au32Sizes) / sizeof(au32Sizes[0]); n++)
+    {
+        u64PerItem = bench_per_item(au32Sizes[n]);
+        u64Bulk = bench_bulk(au32Sizes[n]);
+
+        printf("%9lu   %16.2f   %12.2f   %7.2fx\n",
+               (unsigned long)au32Sizes[n],
+               (double)u64PerItem / BENCH_NUM_ITEMS,
+               (double)u64Bulk / BENCH_NUM_ITEMS,
+               (double)u64PerItem / (double)u64Bulk);
+    }
+
+    return 0;
+}
+
+/****************************************************************************/
+/***        Local Functions                                               ***/
+/****************************************************************************/
+
+/* Time to send and receive BENCH_NUM_ITEMS items one by one, in ns */
+static uint64 bench_per_item(uint32 u32ItemSize)
+{
+    tsQueue sQueue;
+    uint64 u64Start;
+    uint32 u32Done;
+    uint32 n;
+
+    QUEUE_vCreate(&sQueue, BENCH_QUEUE_LENGTH, u32ItemSize, au8Storage);
+
+    u64Start = TEST_u64NowNs();
+    for (u32Done = 0; u32Done < BENCH_NUM_ITEMS; u32Done += BENCH_BATCH)
+    {
+        for (n = 0; n < BENCH_BATCH; n++)
+        {
+            (void)QUEUE_bSend(&sQueue, &au8In[n * u32ItemSize]);
+        }
+        for (n = 0; n < BENCH_BATCH; n++)
+        {
+            (void)QUEUE_bReceive(&sQueue, &au8Out[n * u32ItemSize]);
+        }
+        u32Sink += au8Out[0];
+    }
+
+    return TEST_u64NowNs() - u64Start;
+}
+
+/* Time to send and receive BENCH_NUM_ITEMS items in batches, in ns */
+static uint64 bench_bulk(uint32 u32ItemSize)
+{
+    tsQueue sQueue;
+    uint64 u64Start;
+    uint32 u32Done;
+
+    QUEUE_vCreate(&sQueue, BENCH_QUEUE_LENGTH, u32ItemSize, au8Storage);
+
+    u64Start = TEST_u64NowNs();
+    for (u32Done = 0; u32Done < BENCH_NUM_ITEMS; u32Done += BENCH_BATCH)
+    {
+        (void)QUEUE_u32SendMany(&sQueue, au8In, BENCH_BATCH);
+        (void)QUEUE_u32ReceiveMany(&sQueue, au8Out, BENCH_BATCH);
+        u32Sink += au8Out[0];
+    }
+
+    return TEST_u64NowNs() - u64Start;
+}
+
+/****************************************************************************/
+/***        END OF FILE                                                   ***/
+/****************************************************************************/
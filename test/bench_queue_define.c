@@ -0,0 +1,168 @@
+/****************************************************************************
+ *
+ * MODULE:    bench_queue_define.c
+ *
+ * DESCRIPTION:
+ * Host benchmark of the typed queues of QUEUE_DEFINE against the generic tsQueue
+ * and tsQueueSpsc, for 1, 3 and 8 byte items: one send and one receive per
+ * item, through a queue of 16.
+ *
+ ****************************************************************************
+ *
+ * This software is owned by NXP B.V. and/or its supplier and is protected
+ * under applicable copyright laws. All rights are reserved. We grant You,
+ * and any third parties, a license to use this software solely and
+ * exclusively on NXP products [NXP Microcontrollers such as JN5168, JN5179].
+ * You, and any third parties must reproduce the copyright and warranty notice
+ * and any other legend of ownership on each copy or partial copy of the
+ * software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Copyright NXP B.V. 2016. All rights reserved
+ *
+ ***************************************************************************/
+
+/****************************************************************************/
+/***        Include files                                                 ***/
+/****************************************************************************/
+
+#include "QueueDefine.h"
+#include "test.h"
+
+/****************************************************************************/
+/***        Macro Definitions                                             ***/
+/****************************************************************************/
+
+#define BENCH_QUEUE_LENGTH      (16)
+#define BENCH_NUM_ITEMS         (20000000UL)
+
+/* Times a send and a receive of each of BENCH_NUM_ITEMS items of 'type',
+ * SEND and RECEIVE taking a pointer to the item */
+#define BENCH_RUN(type, SEND, RECEIVE, pu64Ns)                              \
+    do                                                                      \
+    {                                                                       \
+        type sIn;                                                           \
+        type sOut;                                                          \
+        uint64 u64Start;                                                    \
+        uint32 u32Done;                                                     \
+                                                                            \
+        memset(&sIn, 0, sizeof(sIn));                                       \
+        memset(&sOut, 0, sizeof(sOut));                                     \
+        u64Start = TEST_u64NowNs();                                         \
+        for (u32Done = 0; u32Done < BENCH_NUM_ITEMS; u32Done++)             \
+        {                                                                   \
+            *(uint8 *)&sIn = (uint8)u32Done;                                \
+            (void)SEND(&sIn);                                               \
+            (void)RECEIVE(&sOut);                                           \
+            u32Sink += *(uint8 *)&sOut;                                     \
+        }                                                                   \
+        *(pu64Ns) = TEST_u64NowNs() - u64Start;                             \
+    } while (0)
+
+#define BENCH_GENERIC_SEND(pv)      QUEUE_bSend(&sGeneric, (pv))
+#define BENCH_GENERIC_RECEIVE(pv)   QUEUE_bReceive(&sGeneric, (pv))
+#define BENCH_SPSC_SEND(pv)         QUEUE_bSpscSend(&sSpsc, (pv))
+#define BENCH_SPSC_RECEIVE(pv)      QUEUE_bSpscReceive(&sSpsc, (pv))
+
+/****************************************************************************/
+/***        Type Definitions                                              ***/
+/****************************************************************************/
+
+typedef struct
+{
+    uint8   au8Data[3];
+} tsBench3;
+
+/* Laid out as BUTTON_tsEvent and the timer messages */
+typedef struct
+{
+    uint8   u8Index;
+    uint8   u8State;
+    uint16  u16Count;
+    uint32  u32Time;
+} tsBench8;
+
+/****************************************************************************/
+/***        Local Variables                                               ***/
+/****************************************************************************/
+
+QUEUE_DEFINE(BENCH_q1, uint8, BENCH_QUEUE_LENGTH)
+QUEUE_DEFINE(BENCH_q3, tsBench3, BENCH_QUEUE_LENGTH)
+QUEUE_DEFINE(BENCH_q8, tsBench8, BENCH_QUEUE_LENGTH)
+
+static tsQueue sGeneric;
+static tsQueueSpsc sSpsc;
+static uint8 au8Storage[BENCH_QUEUE_LENGTH * sizeof(tsBench8)];
+static volatile uint32 u32Sink;         /* Keeps the copies from being optimised out */
+
+/****************************************************************************/
+/***        Local Function Prototypes                                     ***/
+/****************************************************************************/
+
+static void bench_print(uint32 u32ItemSize, uint64 u64Generic, uint64 u64Spsc, uint64 u64Define);
+
+/****************************************************************************/
+/***        Exported Functions                                            ***/
+/****************************************************************************/
+
+int main(void)
+{
+    uint64 u64Generic;
+    uint64 u64Spsc;
+    uint64 u64Define;
+
+    printf("bench_queue_define: %lu items, queue of %u, ns per send and receive\n",
+           (unsigned long)BENCH_NUM_ITEMS, BENCH_QUEUE_LENGTH);
+    printf("item size    tsQueue   tsQueueSpsc   QUEUE_DEFINE\n");
+
+    QUEUE_vCreate(&sGeneric, BENCH_QUEUE_LENGTH, sizeof(uint8), au8Storage);
+    (void)QUEUE_bSpscCreate(&sSpsc, BENCH_QUEUE_LENGTH, sizeof(uint8), au8Storage);
+    BENCH_RUN(uint8, BENCH_GENERIC_SEND, BENCH_GENERIC_RECEIVE, &u64Generic);
+    BENCH_RUN(uint8, BENCH_SPSC_SEND, BENCH_SPSC_RECEIVE, &u64Spsc);
+    BENCH_RUN(uint8, BENCH_q1_bSend, BENCH_q1_bReceive, &u64Define);
+    bench_print(sizeof(uint8), u64Generic, u64Spsc, u64Define);
+
+    QUEUE_vCreate(&sGeneric, BENCH_QUEUE_LENGTH, sizeof(tsBench3), au8Storage);
+    (void)QUEUE_bSpscCreate(&sSpsc, BENCH_QUEUE_LENGTH, sizeof(tsBench3), au8Storage);
+    BENCH_RUN(tsBench3, BENCH_GENERIC_SEND, BENCH_GENERIC_RECEIVE, &u64Generic);
+    BENCH_RUN(tsBench3, BENCH_SPSC_SEND, BENCH_SPSC_RECEIVE, &u64Spsc);
+    BENCH_RUN(tsBench3, BENCH_q3_bSend, BENCH_q3_bReceive, &u64Define);
+    bench_print(sizeof(tsBench3), u64Generic, u64Spsc, u64Define);
+
+    QUEUE_vCreate(&sGeneric, BENCH_QUEUE_LENGTH, sizeof(tsBench8), au8Storage);
+    (void)QUEUE_bSpscCreate(&sSpsc, BENCH_QUEUE_LENGTH, sizeof(tsBench8), au8Storage);
+    BENCH_RUN(tsBench8, BENCH_GENERIC_SEND, BENCH_GENERIC_RECEIVE, &u64Generic);
+    BENCH_RUN(tsBench8, BENCH_SPSC_SEND, BENCH_SPSC_RECEIVE, &u64Spsc);
+    BENCH_RUN(tsBench8, BENCH_q8_bSend, BENCH_q8_bReceive, &u64Define);
+    bench_print(sizeof(tsBench8), u64Generic, u64Spsc, u64Define);
+
+    return 0;
+}
+
+/****************************************************************************/
+/***        Local Functions                                               ***/
+/****************************************************************************/
+
+static void bench_print(uint32 u32ItemSize, uint64 u64Generic, uint64 u64Spsc, uint64 u64Define)
+{
+    printf("%9lu   %8.2f   %11.2f   %12.2f\n",
+           (unsigned long)u32ItemSize,
+           (double)u64Generic / BENCH_NUM_ITEMS,
+           (double)u64Spsc / BENCH_NUM_ITEMS,
+           (double)u64Define / BENCH_NUM_ITEMS);
+}
+
+/****************************************************************************/
+/***        END OF FILE                                                   ***/
+/****************************************************************************/
@@ -0,0 +1,104 @@
+/****************************************************************************
+ *
+ * MODULE:    bench_queue_index.c
+ *
+ * DESCRIPTION:
+ * Host benchmark of the tsQueue index width. The Makefile builds it once for
+ * each QUEUE_INDEX_WIDTH; every build prints the queue header size and the time
+ * of a send and a receive of 1 byte items, one by one and in batches.
+ *
+ ****************************************************************************
+ *
+ * This software is owned by NXP B.V. and/or its supplier and is protected
+ * under applicable copyright laws. All rights are reserved. We grant You,
+ * and any third parties, a license to use this software solely and
+ * exclusively on NXP products [NXP Microcontrollers such as JN5168, JN5179].
+ * You, and any third parties must reproduce the copyright and warranty notice
+ * and any other legend of ownership on each copy or partial copy of the
+ * software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Copyright NXP B.V. 2016. All rights reserved
+ *
+ ***************************************************************************/
+
+/****************************************************************************/
+/***        Include files                                                 ***/
+/****************************************************************************/
+
+#include "Queue.h"
+#include "test.h"
+
+/****************************************************************************/
+/***        Macro Definitions                                             ***/
+/****************************************************************************/
+
+/* Fits the 8 bit index */
+#define BENCH_QUEUE_LENGTH      (128)
+#define BENCH_BATCH             (48)
+#define BENCH_NUM_ITEMS         (20000000UL)
+
+/****************************************************************************/
+/***        Local Variables                                               ***/
+/****************************************************************************/
+
+static uint8 au8Storage[BENCH_QUEUE_LENGTH];
+static uint8 au8Batch[BENCH_BATCH];
+static volatile uint32 u32Sink;         /* Keeps the copies from being optimised out */
+
+/****************************************************************************/
+/***        Exported Functions                                            ***/
+/****************************************************************************/
+
+int main(void)
+{
+    tsQueue sQueue;
+    uint64 u64Single;
+    uint64 u64Batch;
+    uint64 u64Start;
+    uint32 u32Done;
+    uint8 u8Item;
+
+    QUEUE_vCreate(&sQueue, BENCH_QUEUE_LENGTH, sizeof(uint8), au8Storage);
+
+    u64Start = TEST_u64NowNs();
+    for (u32Done = 0; u32Done < BENCH_NUM_ITEMS; u32Done++)
+    {
+        u8Item = (uint8)u32Done;
+        (void)QUEUE_bSend(&sQueue, &u8Item);
+        (void)QUEUE_bReceive(&sQueue, &u8Item);
+        u32Sink += u8Item;
+    }
+    u64Single = TEST_u64NowNs() - u64Start;
+
+    u64Start = TEST_u64NowNs();
+    for (u32Done = 0; u32Done < BENCH_NUM_ITEMS; u32Done += BENCH_BATCH)
+    {
+        (void)QUEUE_u32SendMany(&sQueue, au8Batch, BENCH_BATCH);
+        (void)QUEUE_u32ReceiveMany(&sQueue, au8Batch, BENCH_BATCH);
+        u32Sink += au8Batch[0];
+    }
+    u64Batch = TEST_u64NowNs() - u64Start;
+
+    printf("bench_queue_index: QUEUE_INDEX_WIDTH=%2u sizeof(tsQueue)=%2lu single %.2f ns/item, batch %.2f ns/item\n",
+           QUEUE_INDEX_WIDTH, (unsigned long)sizeof(tsQueue),
+           (double)u64Single / BENCH_NUM_ITEMS,
+           (double)u64Batch / BENCH_NUM_ITEMS);
+
+    return 0;
+}
+
+/****************************************************************************/
+/***        END OF FILE                                                   ***/
+/****************************************************************************/
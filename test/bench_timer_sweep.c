@@ -0,0 +1,132 @@
+/****************************************************************************
+ *
+ * MODULE:    bench_timer_sweep.c
+ *
+ * DESCRIPTION:
+ * Host benchmark of the timer backends from 8 to 4096 timers. The Makefile
+ * builds it once for each TIMER_BACKEND; every build prints, for each number of
+ * running periodic timers, the time of a TIMER_eStart and of a tick processed
+ * by TIMER_vTask, callbacks included.
+ *
+ ****************************************************************************
+ *
+ * This software is owned by NXP B.V. and/or its supplier and is protected
+ * under applicable copyright laws. All rights are reserved. We grant You,
+ * and any third parties, a license to use this software solely and
+ * exclusively on NXP products [NXP Microcontrollers such as JN5168, JN5179].
+ * You, and any third parties must reproduce the copyright and warranty notice
+ * and any other legend of ownership on each copy or partial copy of the
+ * software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Copyright NXP B.V. 2016. All rights reserved
+ *
+ ***************************************************************************/
+
+/****************************************************************************/
+/***        Include files                                                 ***/
+/****************************************************************************/
+
+#include "Timer.h"
+#include "test.h"
+
+/****************************************************************************/
+/***        Macro Definitions                                             ***/
+/****************************************************************************/
+
+#define BENCH_MAX_TIMERS        (4096)
+#define BENCH_NUM_TICKS         (20000UL)
+
+/* Periods from 1 to 10 s spread over the timers, as application timers are:
+ * a tick only expires a few of them */
+#define BENCH_PERIOD(n)         (1000UL + (((uint32)(n) * 7919UL) % 9000UL))
+
+/****************************************************************************/
+/***        Local Function Prototypes                                     ***/
+/****************************************************************************/
+
+static void bench_callback(void *pvParam);
+
+/****************************************************************************/
+/***        Local Variables                                               ***/
+/****************************************************************************/
+
+static TIMER_tsTimer asTimers[BENCH_MAX_TIMERS];
+static TIMER_tHandle atHandles[BENCH_MAX_TIMERS];
+static uint32 u32Expired;
+
+/****************************************************************************/
+/***        Exported Functions                                            ***/
+/****************************************************************************/
+
+int main(void)
+{
+    static const char *const apcBackends[] = { "scan", "wheel", "sorted" };
+    uint64 u64Start;
+    uint64 u64Starts;
+    uint64 u64Ticks;
+    uint32 u32NumTimers;
+    uint32 n;
+
+    printf("bench_timer_sweep: backend %s, %lu ticks\n",
+           apcBackends[TIMER_BACKEND], (unsigned long)BENCH_NUM_TICKS);
+    printf("  timers   ns/start   ns/tick   expired/tick\n");
+
+    for (u32NumTimers = 8; u32NumTimers <= BENCH_MAX_TIMERS; u32NumTimers *= 2)
+    {
+        (void)TIMER_eInit(asTimers, (uint16)u32NumTimers);
+        for (n = 0; n < u32NumTimers; n++)
+        {
+            (void)TIMER_eOpen(&atHandles[n], bench_callback, NULL, TIMER_FLAG_PERIODIC);
+        }
+
+        u64Start = TEST_u64NowNs();
+        for (n = 0; n < u32NumTimers; n++)
+        {
+            (void)TIMER_eStart(atHandles[n], BENCH_PERIOD(n));
+        }
+        u64Starts = TEST_u64NowNs() - u64Start;
+
+        u32Expired = 0;
+        u64Start = TEST_u64NowNs();
+        for (n = 0; n < BENCH_NUM_TICKS; n++)
+        {
+            ISR_vTickTimer();
+            TIMER_vTask();
+        }
+        u64Ticks = TEST_u64NowNs() - u64Start;
+
+        printf("%8lu   %8.1f   %7.1f   %12.3f\n",
+               (unsigned long)u32NumTimers,
+               (double)u64Starts / u32NumTimers,
+               (double)u64Ticks / BENCH_NUM_TICKS,
+               (double)u32Expired / BENCH_NUM_TICKS);
+    }
+
+    return 0;
+}
+
+/****************************************************************************/
+/***        Local Functions                                               ***/
+/****************************************************************************/
+
+static void bench_callback(void *pvParam)
+{
+    (void)pvParam;
+    u32Expired++;
+}
+
+/****************************************************************************/
+/***        END OF FILE                                                   ***/
+/****************************************************************************/
@@ -0,0 +1,122 @@
+/****************************************************************************
+ *
+ * MODULE:    port_host.c
+ *
+ * DESCRIPTION:
+ * Minimal host port for the tests of components that only need the critical
+ * section, the idle and the time base of port_mcu.h. The critical section is a
+ * recursive mutex, so tests may run a producer and a consumer as two threads.
+ * Tests of the HRT and the kernel use port_hrt_sim.c and port_os_posix.c
+ * instead.
+ *
+ ****************************************************************************
+ *
+ * This software is owned by NXP B.V. and/or its supplier and is protected
+ * under applicable copyright laws. All rights are reserved. We grant You,
+ * and any third parties, a license to use this software solely and
+ * exclusively on NXP products [NXP Microcontrollers such as JN5168, JN5179].
+ * You, and any third parties must reproduce the copyright and warranty notice
+ * and any other legend of ownership on each copy or partial copy of the
+ * software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Copyright NXP B.V. 2016. All rights reserved
+ *
+ ***************************************************************************/
+
+/****************************************************************************/
+/***        Include files                                                 ***/
+/****************************************************************************/
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <pthread.h>
+#include "port_mcu.h"
+
+/****************************************************************************/
+/***        Local Function Prototypes                                     ***/
+/****************************************************************************/
+
+static void host_init(void);
+
+/****************************************************************************/
+/***        Local Variables                                               ***/
+/****************************************************************************/
+
+static pthread_once_t tHostOnce = PTHREAD_ONCE_INIT;
+static pthread_mutex_t sHostMask;
+
+/****************************************************************************/
+/***        Exported Functions                                            ***/
+/****************************************************************************/
+
+uint8 PORTABLE_u8EnterCritical(void)
+{
+    pthread_once(&tHostOnce, host_init);
+    pthread_mutex_lock(&sHostMask);
+
+    return 0;
+}
+
+void PORTABLE_vExitCritical(uint8 u8State)
+{
+    (void)u8State;
+    pthread_mutex_unlock(&sHostMask);
+}
+
+void PORTABLE_vDisableInterrupts(void)
+{
+}
+
+void PORTABLE_vEnableInterrupts(void)
+{
+}
+
+/* Nothing can wake a host test, so the idle returns at once */
+void PORTABLE_vIdle(uint8 u8Mode)
+{
+    (void)u8Mode;
+}
+
+uint16 PORTABLE_u16TimebaseMicros(void)
+{
+    return 0;
+}
+
+void xprintf(const char *fmt, ...)
+{
+    va_list sArgs;
+
+    va_start(sArgs, fmt);
+    vprintf(fmt, sArgs);
+    va_end(sArgs);
+}
+
+/****************************************************************************/
+/***        Local Functions                                               ***/
+/****************************************************************************/
+
+static void host_init(void)
+{
+    pthread_mutexattr_t sAttr;
+
+    pthread_mutexattr_init(&sAttr);
+    pthread_mutexattr_settype(&sAttr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&sHostMask, &sAttr);
+    pthread_mutexattr_destroy(&sAttr);
+}
+
+/****************************************************************************/
+/***        END OF FILE                                                   ***/
+/****************************************************************************/
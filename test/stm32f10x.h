@@ -0,0 +1,108 @@
+/****************************************************************************
+ *
+ * MODULE:    stm32f10x.h
+ *
+ * DESCRIPTION:
+ * Host stand-in for the device header, with only what port_stm32f10x.c uses.
+ * SysTick and the SCB are plain variables that a test sets as the hardware
+ * would; the counter does not run by itself.
+ *
+ ****************************************************************************
+ *
+ * This software is owned by NXP B.V. and/or its supplier and is protected
+ * under applicable copyright laws. All rights are reserved. We grant You,
+ * and any third parties, a license to use this software solely and
+ * exclusively on NXP products [NXP Microcontrollers such as JN5168, JN5179].
+ * You, and any third parties must reproduce the copyright and warranty notice
+ * and any other legend of ownership on each copy or partial copy of the
+ * software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Copyright NXP B.V. 2016. All rights reserved
+ *
+ ***************************************************************************/
+
+#ifndef STM32F10X_H_
+#define STM32F10X_H_
+
+#include <stdint.h>
+
+/****************************************************************************/
+/***        Macro Definitions                                             ***/
+/****************************************************************************/
+
+#define SysTick_CTRL_ENABLE_Msk     (1UL << 0)
+#define SysTick_LOAD_RELOAD_Msk     (0xFFFFFFUL)
+#define SCB_ICSR_PENDSTCLR_Msk      (1UL << 25)
+#define SCB_ICSR_PENDSTSET_Msk      (1UL << 26)
+
+#define SysTick                     (&SIM_sSysTick)
+#define SCB                         (&SIM_sScb)
+
+#define ENABLE                      (1)
+#define RCC_APB1Periph_PWR          (0x10000000UL)
+#define PWR_Regulator_LowPower      (1)
+#define PWR_STOPEntry_WFI           (1)
+
+/****************************************************************************/
+/***        Type Definitions                                              ***/
+/****************************************************************************/
+
+typedef struct
+{
+    volatile uint32_t CTRL;
+    volatile uint32_t LOAD;
+    volatile uint32_t VAL;
+    volatile uint32_t CALIB;
+} SysTick_Type;
+
+typedef struct
+{
+    volatile uint32_t ICSR;
+} SCB_Type;
+
+/****************************************************************************/
+/***        Exported Variables                                            ***/
+/****************************************************************************/
+
+/* Defined by the test */
+extern uint32_t SystemCoreClock;
+extern SysTick_Type SIM_sSysTick;
+extern SCB_Type SIM_sScb;
+extern uint32_t SIM_u32Primask;
+
+/****************************************************************************/
+/***        Exported Functions                                            ***/
+/****************************************************************************/
+
+static inline void SystemInit(void) {}
+static inline void SystemCoreClockUpdate(void) {}
+static inline void __WFI(void) {}
+static inline void __disable_irq(void) { SIM_u32Primask = 1; }
+static inline void __enable_irq(void) { SIM_u32Primask = 0; }
+static inline uint32_t __get_PRIMASK(void) { return SIM_u32Primask; }
+static inline void __set_PRIMASK(uint32_t u32Mask) { SIM_u32Primask = u32Mask; }
+static inline void RCC_APB1PeriphClockCmd(uint32_t u32Periph, int iState) { (void)u32Periph; (void)iState; }
+static inline void PWR_EnterSTOPMode(int iRegulator, int iEntry) { (void)iRegulator; (void)iEntry; }
+static inline void PWR_EnterSTANDBYMode(void) {}
+
+static inline uint32_t SysTick_Config(uint32_t u32Ticks)
+{
+    SIM_sSysTick.LOAD = u32Ticks - 1;
+    SIM_sSysTick.VAL = 0;
+    SIM_sSysTick.CTRL = SysTick_CTRL_ENABLE_Msk;
+    return 0;
+}
+
+#endif /*STM32F10X_H_*/
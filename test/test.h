@@ -0,0 +1,82 @@
+/****************************************************************************
+ *
+ * MODULE:    test.h
+ *
+ * DESCRIPTION:
+ * Checks and timing shared by the host tests and benchmarks
+ *
+ ****************************************************************************
+ *
+ * This software is owned by NXP B.V. and/or its supplier and is protected
+ * under applicable copyright laws. All rights are reserved. We grant You,
+ * and any third parties, a license to use this software solely and
+ * exclusively on NXP products [NXP Microcontrollers such as JN5168, JN5179].
+ * You, and any third parties must reproduce the copyright and warranty notice
+ * and any other legend of ownership on each copy or partial copy of the
+ * software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Copyright NXP B.V. 2016. All rights reserved
+ *
+ ***************************************************************************/
+
+#ifndef TEST_H_
+#define TEST_H_
+
+#include <stdio.h>
+#include <time.h>
+#include "chip_selection.h"
+
+/****************************************************************************/
+/***        Macro Definitions                                             ***/
+/****************************************************************************/
+
+/* Counts and reports a failed condition, the test goes on */
+#define TEST_CHECK(bCondition)                                              \
+    do                                                                      \
+    {                                                                       \
+        if (!(bCondition))                                                  \
+        {                                                                   \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #bCondition); \
+            TEST_u32Failures++;                                             \
+        }                                                                   \
+    } while (0)
+
+/****************************************************************************/
+/***        Local Variables                                               ***/
+/****************************************************************************/
+
+static uint32 TEST_u32Failures;
+
+/****************************************************************************/
+/***        Exported Functions                                            ***/
+/****************************************************************************/
+
+/* Exit status of a test: 0 when every check passed */
+static inline int TEST_iResult(const char *pcName)
+{
+    printf("%s: %s\n", pcName, (TEST_u32Failures == 0) ? "PASS" : "FAIL");
+    return (TEST_u32Failures == 0) ? 0 : 1;
+}
+
+/* Host monotonic clock in ns, for the benchmarks */
+static inline uint64 TEST_u64NowNs(void)
+{
+    struct timespec sNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &sNow);
+    return (uint64)sNow.tv_sec * 1000000000u + (uint64)sNow.tv_nsec;
+}
+
+#endif /*TEST_H_*/
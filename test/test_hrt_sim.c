@@ -0,0 +1,202 @@
+/****************************************************************************
+ *
+ * MODULE:    test_hrt_sim.c
+ *
+ * DESCRIPTION:
+ * Test of the high resolution one-shot timers on the simulated TIM2 of
+ * port_hrt_sim.c. Timers are armed out of order around the 16 bit overflow of
+ * the counter, one of them several overflows ahead, one closer than
+ * HRT_MIN_LEAD_US and one re-arming itself from its callback. They must fire
+ * in deadline order, timers with the same deadline in the order they were
+ * armed, never before their deadline and within a few simulated microseconds
+ * of it. The simulated counter also moves on by one on every read, as the
+ * real one would meanwhile.
+ *
+ ****************************************************************************
+ *
+ * This software is owned by NXP B.V. and/or its supplier and is protected
+ * under applicable copyright laws. All rights are reserved. We grant You,
+ * and any third parties, a license to use this software solely and
+ * exclusively on NXP products [NXP Microcontrollers such as JN5168, JN5179].
+ * You, and any third parties must reproduce the copyright and warranty notice
+ * and any other legend of ownership on each copy or partial copy of the
+ * software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Copyright NXP B.V. 2016. All rights reserved
+ *
+ ***************************************************************************/
+
+/****************************************************************************/
+/***        Include files                                                 ***/
+/****************************************************************************/
+
+#include "port_mcu.h"
+#include "port_hrt.h"
+#include "test.h"
+
+/****************************************************************************/
+/***        Macro Definitions                                             ***/
+/****************************************************************************/
+
+#define SIM_NUM_TIMERS          (8)
+#define SIM_MAX_FIRED           (16)
+
+/* Late firing allowed: a deadline closer than HRT_MIN_LEAD_US interrupts that
+ * far ahead, plus the counter reads of the ISR itself */
+#define SIM_TOLERANCE_US        (HRT_MIN_LEAD_US + 8)
+
+/* Start of the test, just before the first counter overflow */
+#define SIM_START_US            (0xFFC0UL)
+
+/* Period of the timer that re-arms itself, across each overflow */
+#define SIM_REARM_US            (40000UL)
+#define SIM_REARM_COUNT         (4)
+
+/****************************************************************************/
+/***        Type Definitions                                              ***/
+/****************************************************************************/
+
+typedef struct
+{
+    uint8   u8Timer;
+    uint32  u32Deadline;
+    uint32  u32At;
+} tsSimFired;
+
+/****************************************************************************/
+/***        Local Function Prototypes                                     ***/
+/****************************************************************************/
+
+static void sim_callback(void *pvParam);
+static void sim_rearm(void *pvParam);
+
+/****************************************************************************/
+/***        Local Variables                                               ***/
+/****************************************************************************/
+
+static HRT_tsTimer asTimers[SIM_NUM_TIMERS];
+static uint8 au8Index[SIM_NUM_TIMERS] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+static tsSimFired asFired[SIM_MAX_FIRED];
+static uint8 u8NumFired;
+static uint8 u8Rearms;
+
+/****************************************************************************/
+/***        Exported Functions                                            ***/
+/****************************************************************************/
+
+int main(void)
+{
+    /* Offsets from the start, armed in this order; timer 4 is cancelled and
+     * timer 7 re-arms itself */
+    static const uint32 au32Offset[SIM_NUM_TIMERS] =
+    {
+        250000UL,                       /* Three overflows ahead */
+        100UL,                          /* Just after the first overflow */
+        40UL,                           /* Just before it */
+        100UL,                          /* Same deadline as timer 1 */
+        150UL,
+        70000UL,                        /* More than a counter period ahead */
+        2UL,                            /* From its arming, closer than HRT_MIN_LEAD_US */
+        SIM_REARM_US
+    };
+    static const uint8 au8Order[] = { 6, 2, 1, 3, 7, 5, 7, 7, 7, 0 };
+    uint32 u32Start;
+    uint32 u32Now;
+    uint8 n;
+
+    HRT_vInit();
+    PORTABLE_vHrtSimAdvance(SIM_START_US);
+    u32Start = HRT_u32Now();
+    TEST_CHECK((u32Start >= SIM_START_US) && (u32Start < 0x10000UL));
+
+    for (n = 0; n < SIM_NUM_TIMERS; n++)
+    {
+        if (n == 6)
+        {
+            TEST_CHECK(HRT_bStart(&asTimers[n], au32Offset[n], sim_callback, &au8Index[n]));
+        }
+        else
+        {
+            TEST_CHECK(HRT_bStartAt(&asTimers[n], u32Start + au32Offset[n],
+                                    (n == 7) ? sim_rearm : sim_callback, &au8Index[n]));
+        }
+    }
+    TEST_CHECK(HRT_bCancel(&asTimers[4]));
+    TEST_CHECK(!HRT_bCancel(&asTimers[4]));
+    TEST_CHECK(!HRT_bStart(&asTimers[4], 0x80000000UL, sim_callback, &au8Index[4]));
+
+    /* In steps, so that the overflows come between ISR runs as well */
+    for (n = 0; n < 100; n++)
+    {
+        PORTABLE_vHrtSimAdvance(3000);
+    }
+
+    u32Now = HRT_u32Now();
+    TEST_CHECK((u32Now - u32Start) >= 300000UL);
+    TEST_CHECK(u32Now > 0x40000UL);
+
+    TEST_CHECK(u8NumFired == sizeof(au8Order));
+    for (n = 0; (n < u8NumFired) && (n < sizeof(au8Order)); n++)
+    {
+        printf("timer %u deadline %6lu fired %6lu\n", asFired[n].u8Timer,
+               (unsigned long)(asFired[n].u32Deadline - u32Start),
+               (unsigned long)(asFired[n].u32At - u32Start));
+        TEST_CHECK(asFired[n].u8Timer == au8Order[n]);
+        TEST_CHECK((int32)(asFired[n].u32At - asFired[n].u32Deadline) >= 0);
+        TEST_CHECK((asFired[n].u32At - asFired[n].u32Deadline) <= SIM_TOLERANCE_US);
+    }
+    for (n = 0; n < SIM_NUM_TIMERS; n++)
+    {
+        TEST_CHECK(!HRT_bIsArmed(&asTimers[n]));
+    }
+
+    return TEST_iResult("test_hrt_sim");
+}
+
+/****************************************************************************/
+/***        Local Functions                                               ***/
+/****************************************************************************/
+
+static void sim_callback(void *pvParam)
+{
+    uint8 u8Timer = *(uint8 *)pvParam;
+
+    if (u8NumFired < SIM_MAX_FIRED)
+    {
+        asFired[u8NumFired].u8Timer = u8Timer;
+        asFired[u8NumFired].u32Deadline = asTimers[u8Timer].u32Deadline;
+        asFired[u8NumFired].u32At = HRT_u32Now();
+    }
+    u8NumFired++;
+}
+
+/* Re-arms from its own deadline, so that no drift builds up */
+static void sim_rearm(void *pvParam)
+{
+    uint8 u8Timer = *(uint8 *)pvParam;
+
+    sim_callback(pvParam);
+
+    if (++u8Rearms < SIM_REARM_COUNT)
+    {
+        TEST_CHECK(!HRT_bIsArmed(&asTimers[u8Timer]));
+        TEST_CHECK(HRT_bStartAt(&asTimers[u8Timer], asTimers[u8Timer].u32Deadline + SIM_REARM_US,
+                                sim_rearm, pvParam));
+    }
+}
+
+/****************************************************************************/
+/***        END OF FILE                                                   ***/
+/****************************************************************************/
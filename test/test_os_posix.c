@@ -0,0 +1,295 @@
+/****************************************************************************
+ *
+ * MODULE:    test_os_posix.c
+ *
+ * DESCRIPTION:
+ * Test of the kernel on the POSIX port of port_os_posix.c. A controller thread
+ * checks that a thread of a higher priority runs as soon as it is created or
+ * raised and one of a lower priority only once the controller waits, that
+ * osSemaphoreRelease and osMessagePut hand over straight to a waiting thread,
+ * that waits and puts time out, and that periodic and one-shot osTimers fire as
+ * often as they should. alarm() ends a test that hangs.
+ *
+ ****************************************************************************
+ *
+ * This software is owned by NXP B.V. and/or its supplier and is protected
+ * under applicable copyright laws. All rights are reserved. We grant You,
+ * and any third parties, a license to use this software solely and
+ * exclusively on NXP products [NXP Microcontrollers such as JN5168, JN5179].
+ * You, and any third parties must reproduce the copyright and warranty notice
+ * and any other legend of ownership on each copy or partial copy of the
+ * software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Copyright NXP B.V. 2016. All rights reserved
+ *
+ ***************************************************************************/
+
+/****************************************************************************/
+/***        Include files                                                 ***/
+/****************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <unistd.h>
+#include "cmsis_os.h"
+#include "Timer.h"
+#include "test.h"
+
+/****************************************************************************/
+/***        Macro Definitions                                             ***/
+/****************************************************************************/
+
+#define OSPX_NUM_TIMERS         (4)
+#define OSPX_NUM_MESSAGES       (5)
+#define OSPX_WATCHDOG_S         (20)
+
+/* osTimer period and the time it runs for, ticks (ms) */
+#define OSPX_PERIOD             (5)
+#define OSPX_RUN                (50)
+
+/****************************************************************************/
+/***        Local Function Prototypes                                     ***/
+/****************************************************************************/
+
+static void ospx_log(char cEvent);
+static void ospx_vController(void const *argument);
+static void ospx_vWorker(void const *argument);
+static void ospx_vGetter(void const *argument);
+static void ospx_vLow(void const *argument);
+static void ospx_vPeriodic(void const *argument);
+static void ospx_vOnce(void const *argument);
+
+/****************************************************************************/
+/***        Local Variables                                               ***/
+/****************************************************************************/
+
+static TIMER_tsTimer asTimers[OSPX_NUM_TIMERS];
+
+osThreadDef(ospx_vController, osPriorityNormal, 1, 0);
+osThreadDef(ospx_vWorker, osPriorityAboveNormal, 1, 0);
+osThreadDef(ospx_vGetter, osPriorityAboveNormal, 1, 0);
+osThreadDef(ospx_vLow, osPriorityBelowNormal, 1, 0);
+osSemaphoreDef(sWork);
+osSemaphoreDef(sNever);
+osMessageQDef(sHandoff, 4, uint32_t);
+osMessageQDef(sFull, 2, uint32_t);
+osTimerDef(sPeriodic, ospx_vPeriodic);
+osTimerDef(sOnce, ospx_vOnce);
+
+static osSemaphoreId tWork;
+static osSemaphoreId tNever;
+static osMessageQId tHandoff;
+static osMessageQId tFull;
+
+static char acLog[16];
+static uint32 u32LogLength;
+static volatile uint32 u32WorkerRuns;
+static volatile uint32 u32Got;
+static uint32 au32Got[OSPX_NUM_MESSAGES];
+static volatile bool_t bLowRan;
+static volatile bool_t bLowRaised;
+static volatile uint32 u32Periodic;
+static volatile uint32 u32Once;
+
+/****************************************************************************/
+/***        Exported Functions                                            ***/
+/****************************************************************************/
+
+int main(void)
+{
+    alarm(OSPX_WATCHDOG_S);
+
+    (void)TIMER_eInit(asTimers, OSPX_NUM_TIMERS);
+    (void)osKernelInitialize();
+
+    tWork = osSemaphoreCreate(osSemaphore(sWork), 0);
+    tNever = osSemaphoreCreate(osSemaphore(sNever), 0);
+    tHandoff = osMessageCreate(osMessageQ(sHandoff), NULL);
+    tFull = osMessageCreate(osMessageQ(sFull), NULL);
+    (void)osThreadCreate(osThread(ospx_vController), NULL);
+
+    (void)osKernelStart();
+
+    return 1;
+}
+
+void xprintf(const char *fmt, ...)
+{
+    va_list sArgs;
+
+    va_start(sArgs, fmt);
+    vprintf(fmt, sArgs);
+    va_end(sArgs);
+}
+
+/****************************************************************************/
+/***        Local Functions                                               ***/
+/****************************************************************************/
+
+static void ospx_log(char cEvent)
+{
+    if (u32LogLength < sizeof(acLog) - 1)
+    {
+        acLog[u32LogLength++] = cEvent;
+    }
+}
+
+static void ospx_vController(void const *argument)
+{
+    osThreadId tLow;
+    osTimerId tTimer;
+    osEvent sEvent;
+    uint64 u64Start;
+    uint32 u32Runs;
+    uint32 u32Count;
+    uint32 i;
+
+    (void)argument;
+
+    /* A higher priority runs at once, a lower one only while this one waits */
+    ospx_log('C');
+    (void)osThreadCreate(osThread(ospx_vWorker), NULL);
+    ospx_log('c');
+    TEST_CHECK(strcmp(acLog, "CWc") == 0);
+
+    tLow = osThreadCreate(osThread(ospx_vLow), NULL);
+    TEST_CHECK(tLow != NULL);
+    TEST_CHECK(!bLowRan);
+    (void)osDelay(2);
+    TEST_CHECK(bLowRan);
+
+    /* The low thread is ready and spinning, raising it above this one runs it */
+    TEST_CHECK(osThreadSetPriority(tLow, osPriorityAboveNormal) == osOK);
+    TEST_CHECK(bLowRaised);
+
+    /* Releasing the semaphore runs the worker waiting on it before returning */
+    for (i = 0; i < 3; i++)
+    {
+        u32Runs = u32WorkerRuns;
+        TEST_CHECK(osSemaphoreRelease(tWork) == osOK);
+        TEST_CHECK(u32WorkerRuns == u32Runs + 1);
+    }
+
+    u64Start = TEST_u64NowNs();
+    TEST_CHECK(osSemaphoreWait(tNever, 10) == 0);
+    TEST_CHECK(TEST_u64NowNs() - u64Start >= 9000000u);
+
+    /* Each message goes straight to the waiting getter */
+    (void)osThreadCreate(osThread(ospx_vGetter), NULL);
+    for (i = 0; i < OSPX_NUM_MESSAGES; i++)
+    {
+        TEST_CHECK(osMessagePut(tHandoff, i + 1, 0) == osOK);
+        TEST_CHECK(u32Got == i + 1);
+    }
+    for (i = 0; i < OSPX_NUM_MESSAGES; i++)
+    {
+        TEST_CHECK(au32Got[i] == i + 1);
+    }
+
+    /* Without a receiver the queue fills up, then empties in order */
+    TEST_CHECK(osMessagePut(tFull, 10, 0) == osOK);
+    TEST_CHECK(osMessagePut(tFull, 20, 0) == osOK);
+    TEST_CHECK(osMessagePut(tFull, 30, 0) != osOK);
+    sEvent = osMessageGet(tFull, 0);
+    TEST_CHECK(sEvent.status == osEventMessage && sEvent.value.v == 10);
+    sEvent = osMessageGet(tFull, 0);
+    TEST_CHECK(sEvent.status == osEventMessage && sEvent.value.v == 20);
+    sEvent = osMessageGet(tFull, 5);
+    TEST_CHECK(sEvent.status == osEventTimeout);
+
+    /* A periodic timer fires once a period until it is stopped */
+    tTimer = osTimerCreate(osTimer(sPeriodic), osTimerPeriodic, NULL);
+    TEST_CHECK(tTimer != NULL);
+    TEST_CHECK(osTimerStart(tTimer, OSPX_PERIOD) == osOK);
+    (void)osDelay(OSPX_RUN);
+    TEST_CHECK(osTimerStop(tTimer) == osOK);
+    u32Count = u32Periodic;
+    TEST_CHECK(u32Count >= OSPX_RUN / OSPX_PERIOD - 2 && u32Count <= OSPX_RUN / OSPX_PERIOD + 1);
+    (void)osDelay(4 * OSPX_PERIOD);
+    TEST_CHECK(u32Periodic == u32Count);
+
+    /* A one-shot timer fires once */
+    tTimer = osTimerCreate(osTimer(sOnce), osTimerOnce, NULL);
+    TEST_CHECK(tTimer != NULL);
+    TEST_CHECK(osTimerStart(tTimer, OSPX_PERIOD) == osOK);
+    (void)osDelay(6 * OSPX_PERIOD);
+    TEST_CHECK(u32Once == 1);
+
+    exit(TEST_iResult("test_os_posix"));
+}
+
+static void ospx_vWorker(void const *argument)
+{
+    (void)argument;
+
+    ospx_log('W');
+    for (;;)
+    {
+        if (osSemaphoreWait(tWork, osWaitForever) > 0)
+        {
+            u32WorkerRuns++;
+        }
+    }
+}
+
+static void ospx_vGetter(void const *argument)
+{
+    osEvent sEvent;
+
+    (void)argument;
+
+    for (;;)
+    {
+        sEvent = osMessageGet(tHandoff, osWaitForever);
+        if (sEvent.status == osEventMessage && u32Got < OSPX_NUM_MESSAGES)
+        {
+            au32Got[u32Got++] = sEvent.value.v;
+        }
+    }
+}
+
+/* Stays ready; on the host a thread is only switched out as it leaves a
+ * critical section, which osThreadYield does for the threads above it */
+static void ospx_vLow(void const *argument)
+{
+    (void)argument;
+
+    bLowRan = TRUE;
+    while (osThreadGetPriority(osThreadGetId()) != osPriorityAboveNormal)
+    {
+        (void)osThreadYield();
+    }
+    bLowRaised = TRUE;
+    (void)osSemaphoreWait(tNever, osWaitForever);
+}
+
+static void ospx_vPeriodic(void const *argument)
+{
+    (void)argument;
+
+    u32Periodic++;
+}
+
+static void ospx_vOnce(void const *argument)
+{
+    (void)argument;
+
+    u32Once++;
+}
+
+/****************************************************************************/
+/***        END OF FILE                                                   ***/
+/****************************************************************************/
@@ -0,0 +1,211 @@
+/****************************************************************************
+ *
+ * MODULE:    test_queue_spsc.c
+ *
+ * DESCRIPTION:
+ * Stress test of the lock free single producer / single consumer queue: a
+ * producer thread and a consumer thread pass numbered items through small rings
+ * until the 16 bit free running indices have wrapped many times. Every item must
+ * arrive once, in order and whole.
+ * make check passes SPSC_NUM_ITEMS items through each ring, a few seconds on
+ * the host. The long run is opt-in: give the number of items as the argument,
+ * e.g. build/test_queue_spsc 4000000000 for billions, or rebuild with another
+ * -DSPSC_NUM_ITEMS.
+ *
+ ****************************************************************************
+ *
+ * This software is owned by NXP B.V. and/or its supplier and is protected
+ * under applicable copyright laws. All rights are reserved. We grant You,
+ * and any third parties, a license to use this software solely and
+ * exclusively on NXP products [NXP Microcontrollers such as JN5168, JN5179].
+ * You, and any third parties must reproduce the copyright and warranty notice
+ * and any other legend of ownership on each copy or partial copy of the
+ * software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Copyright NXP B.V. 2016. All rights reserved
+ *
+ ***************************************************************************/
+
+/****************************************************************************/
+/***        Include files                                                 ***/
+/****************************************************************************/
+
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include "Queue.h"
+#include "test.h"
+
+/****************************************************************************/
+/***        Macro Definitions                                             ***/
+/****************************************************************************/
+
+#ifndef SPSC_NUM_ITEMS
+#define SPSC_NUM_ITEMS          (2000000ULL)
+#endif
+
+/****************************************************************************/
+/***        Type Definitions                                              ***/
+/****************************************************************************/
+
+/* The check word catches an item read while it was still being written */
+typedef struct
+{
+    uint32  u32Sequence;
+    uint32  u32Check;
+    uint8   au8Pad[5];                  /* Odd size, copies are not word sized */
+} tsSpscItem;
+
+typedef struct
+{
+    tsQueueSpsc sQueue;
+    uint64      u64Received;
+    uint32      u32OutOfOrder;
+    uint32      u32Torn;
+} tsSpscRun;
+
+/****************************************************************************/
+/***        Local Function Prototypes                                     ***/
+/****************************************************************************/
+
+static void *spsc_producer(void *pvParam);
+static void *spsc_consumer(void *pvParam);
+static void spsc_run(uint32 u32Length);
+
+/****************************************************************************/
+/***        Local Variables                                               ***/
+/****************************************************************************/
+
+static uint64 u64NumItems = SPSC_NUM_ITEMS;
+
+/****************************************************************************/
+/***        Exported Functions                                            ***/
+/****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+    static uint8 au8Storage[sizeof(tsSpscItem)];
+    tsQueueSpsc sQueue;
+
+    if (argc > 1)
+    {
+        u64NumItems = strtoull(argv[1], NULL, 0);
+    }
+
+    /* Lengths the queue must refuse */
+    TEST_CHECK(!QUEUE_bSpscCreate(&sQueue, 0, sizeof(tsSpscItem), au8Storage));
+    TEST_CHECK(!QUEUE_bSpscCreate(&sQueue, 3, sizeof(tsSpscItem), au8Storage));
+    TEST_CHECK(!QUEUE_bSpscCreate(&sQueue, 0x10000UL, sizeof(tsSpscItem), au8Storage));
+
+    spsc_run(1);
+    spsc_run(2);
+    spsc_run(64);
+
+    return TEST_iResult("test_queue_spsc");
+}
+
+/****************************************************************************/
+/***        Local Functions                                               ***/
+/****************************************************************************/
+
+static void spsc_run(uint32 u32Length)
+{
+    static uint8 au8Storage[64 * sizeof(tsSpscItem)];
+    tsSpscRun sRun = { 0 };
+    pthread_t tProducer;
+    pthread_t tConsumer;
+
+    TEST_CHECK(QUEUE_bSpscCreate(&sRun.sQueue, u32Length, sizeof(tsSpscItem), au8Storage));
+
+    pthread_create(&tConsumer, NULL, spsc_consumer, &sRun);
+    pthread_create(&tProducer, NULL, spsc_producer, &sRun);
+    pthread_join(tProducer, NULL);
+    pthread_join(tConsumer, NULL);
+
+    printf("length %3lu: received %llu, out of order %lu, torn %lu\n",
+           (unsigned long)u32Length, (unsigned long long)sRun.u64Received,
+           (unsigned long)sRun.u32OutOfOrder, (unsigned long)sRun.u32Torn);
+
+    TEST_CHECK(sRun.u64Received == u64NumItems);
+    TEST_CHECK(sRun.u32OutOfOrder == 0);
+    TEST_CHECK(sRun.u32Torn == 0);
+    TEST_CHECK(QUEUE_bSpscIsEmpty(&sRun.sQueue));
+}
+
+static void *spsc_producer(void *pvParam)
+{
+    tsSpscRun *psRun = (tsSpscRun *)pvParam;
+    tsSpscItem sItem = { 0 };
+    uint64 u64Sent;
+
+    /* Sequence numbers wrap at 32 bits on a long run, the consumer follows */
+    for (u64Sent = 0; u64Sent < u64NumItems; u64Sent++)
+    {
+        sItem.u32Sequence = (uint32)u64Sent;
+        sItem.u32Check = ~sItem.u32Sequence;
+        memset(sItem.au8Pad, (uint8)u64Sent, sizeof(sItem.au8Pad));
+
+        while (!QUEUE_bSpscSend(&psRun->sQueue, &sItem))
+        {
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+static void *spsc_consumer(void *pvParam)
+{
+    tsSpscRun *psRun = (tsSpscRun *)pvParam;
+    tsSpscItem sItem;
+    uint32 u32Expected = 0;
+    uint8 n;
+
+    while (psRun->u64Received < u64NumItems)
+    {
+        if (!QUEUE_bSpscReceive(&psRun->sQueue, &sItem))
+        {
+            sched_yield();
+            continue;
+        }
+
+        if (sItem.u32Check != ~sItem.u32Sequence)
+        {
+            psRun->u32Torn++;
+        }
+        for (n = 0; n < sizeof(sItem.au8Pad); n++)
+        {
+            if (sItem.au8Pad[n] != (uint8)sItem.u32Sequence)
+            {
+                psRun->u32Torn++;
+                break;
+            }
+        }
+        if (sItem.u32Sequence != u32Expected)
+        {
+            psRun->u32OutOfOrder++;
+        }
+
+        /* Resynchronise so that one fault is not counted for every later item */
+        u32Expected = sItem.u32Sequence + 1;
+        psRun->u64Received++;
+    }
+
+    return NULL;
+}
+
+/****************************************************************************/
+/***        END OF FILE                                                   ***/
+/****************************************************************************/
@@ -0,0 +1,145 @@
+/****************************************************************************
+ *
+ * MODULE:    test_systick_restore.c
+ *
+ * DESCRIPTION:
+ * Test of the SysTick time base of port_stm32f10x.c around a tickless stretch,
+ * on the register stand-ins of stm32f10x.h. PORTABLE_u16TimebaseMicros is read
+ * straight after PORTABLE_u32TimebaseRestore, in a first period shorter than a
+ * tick and in one that runs on past a boundary too close to program, and must
+ * stay within the tick.
+ *
+ ****************************************************************************
+ *
+ * This software is owned by NXP B.V. and/or its supplier and is protected
+ * under applicable copyright laws. All rights are reserved. We grant You,
+ * and any third parties, a license to use this software solely and
+ * exclusively on NXP products [NXP Microcontrollers such as JN5168, JN5179].
+ * You, and any third parties must reproduce the copyright and warranty notice
+ * and any other legend of ownership on each copy or partial copy of the
+ * software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Copyright NXP B.V. 2016. All rights reserved
+ *
+ ***************************************************************************/
+
+/****************************************************************************/
+/***        Include files                                                 ***/
+/****************************************************************************/
+
+#include "port_mcu.h"
+#include "test.h"
+
+/****************************************************************************/
+/***        Macro Definitions                                             ***/
+/****************************************************************************/
+
+#define SYSTICK_CLOCK           (72000000UL)
+#define SYSTICK_TICK            (SYSTICK_CLOCK / 1000)
+
+/****************************************************************************/
+/***        Local Function Prototypes                                     ***/
+/****************************************************************************/
+
+static uint32 systick_wake(uint32 u32Start, uint32 u32Ticks, uint32 u32Cycles);
+
+/****************************************************************************/
+/***        Exported Variables                                            ***/
+/****************************************************************************/
+
+uint32_t SystemCoreClock = SYSTICK_CLOCK;
+SysTick_Type SIM_sSysTick;
+SCB_Type SIM_sScb;
+uint32_t SIM_u32Primask;
+
+/****************************************************************************/
+/***        Exported Functions                                            ***/
+/****************************************************************************/
+
+int main(void)
+{
+    PORTABLE_vInit();
+
+    /* Woken half way through a tick: a first period of half a tick */
+    TEST_CHECK(systick_wake(SYSTICK_TICK / 2, 10, 3 * SYSTICK_TICK + SYSTICK_TICK / 2) == 3);
+    TEST_CHECK(PORTABLE_u16TimebaseMicros() == 500);
+    SysTick->VAL = 0;
+    TEST_CHECK(PORTABLE_u16TimebaseMicros() == 999);
+
+    /* Woken 10 cycles before a boundary: it is counted, and the first period
+     * runs on to the boundary after it */
+    TEST_CHECK(systick_wake(SYSTICK_TICK / 2, 10, 3 * SYSTICK_TICK - 10) == 3);
+    TEST_CHECK(PORTABLE_u16TimebaseMicros() == 0);
+    SysTick->VAL = SYSTICK_TICK;
+    TEST_CHECK(PORTABLE_u16TimebaseMicros() == 0);
+    SysTick->VAL = SYSTICK_TICK - 1 - SYSTICK_TICK / 100;
+    TEST_CHECK(PORTABLE_u16TimebaseMicros() == 10);
+
+    /* Woken by the interrupt ending the stretch, still pending */
+    TEST_CHECK(systick_wake(SYSTICK_TICK / 2, 10, 0) == 10);
+    TEST_CHECK(PORTABLE_u16TimebaseMicros() == 0);
+    TEST_CHECK((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) == 0);
+
+    return TEST_iResult("test_systick_restore");
+}
+
+/****************************************************************************/
+/***        Local Functions                                               ***/
+/****************************************************************************/
+
+/* Stretches u32Ticks with u32Start cycles left in the current tick, wakes
+ * u32Cycles after the start of that tick (0: on the interrupt ending the
+ * stretch) and restores. SysTick is left as it reloads the first period, the
+ * reading straight after the restore. */
+static uint32 systick_wake(uint32 u32Start, uint32 u32Ticks, uint32 u32Cycles)
+{
+    uint32 u32StretchLoad;
+    uint32 u32Ticked;
+    uint32 u32First;
+
+    SysTick->LOAD = SYSTICK_TICK - 1;
+    SysTick->VAL = u32Start;
+    SCB->ICSR = 0;
+    TEST_CHECK(PORTABLE_bTimebaseStretch(u32Ticks));
+    u32StretchLoad = SysTick->LOAD;
+
+    if (u32Cycles == 0)
+    {
+        SysTick->VAL = u32StretchLoad;
+        SCB->ICSR = SCB_ICSR_PENDSTSET_Msk;
+    }
+    else
+    {
+        SysTick->VAL = u32StretchLoad - (u32Cycles - (SYSTICK_TICK - u32Start));
+    }
+
+    u32Ticked = PORTABLE_u32TimebaseRestore(FALSE);
+
+    /* The first period was loaded before the tick reload value was set */
+    u32First = (u32Cycles == 0) ? SYSTICK_TICK : SYSTICK_TICK - (u32Cycles % SYSTICK_TICK);
+    if (u32First < 32)
+    {
+        u32First += SYSTICK_TICK;
+    }
+    TEST_CHECK(SysTick->LOAD == SYSTICK_TICK - 1);
+    TEST_CHECK((SysTick->CTRL & SysTick_CTRL_ENABLE_Msk) != 0);
+    SysTick->VAL = u32First - 1;
+
+    return u32Ticked;
+}
+
+/****************************************************************************/
+/***        END OF FILE                                                   ***/
+/****************************************************************************/
@@ -0,0 +1,135 @@
+/****************************************************************************
+ *
+ * MODULE:    test_timer_range.c
+ *
+ * DESCRIPTION:
+ * Timers started for 2^31 ticks or more must not count as due: every backend
+ * keeps the full 32 bit range of TIMER_eStart. More ticks than 16 bits hold
+ * must be caught up by a single TIMER_vTask. The Makefile builds the test
+ * once for each TIMER_BACKEND.
+ *
+ ****************************************************************************
+ *
+ * This software is owned by NXP B.V. and/or its supplier and is protected
+ * under applicable copyright laws. All rights are reserved. We grant You,
+ * and any third parties, a license to use this software solely and
+ * exclusively on NXP products [NXP Microcontrollers such as JN5168, JN5179].
+ * You, and any third parties must reproduce the copyright and warranty notice
+ * and any other legend of ownership on each copy or partial copy of the
+ * software.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Copyright NXP B.V. 2016. All rights reserved
+ *
+ ***************************************************************************/
+
+/****************************************************************************/
+/***        Include files                                                 ***/
+/****************************************************************************/
+
+#include "Timer.h"
+#include "test.h"
+
+/****************************************************************************/
+/***        Macro Definitions                                             ***/
+/****************************************************************************/
+
+#define RANGE_NUM_TIMERS        (4)
+#define RANGE_NUM_TICKS         (10)
+
+/* Ticks raised before TIMER_vTask catches up, more than 16 bits hold */
+#define RANGE_CATCH_UP          (70000UL)
+
+/****************************************************************************/
+/***        Local Function Prototypes                                     ***/
+/****************************************************************************/
+
+static void range_callback(void *pvParam);
+
+/****************************************************************************/
+/***        Local Variables                                               ***/
+/****************************************************************************/
+
+static TIMER_tsTimer asTimers[RANGE_NUM_TIMERS];
+static uint8 au8Fired[RANGE_NUM_TIMERS];
+
+/****************************************************************************/
+/***        Exported Functions                                            ***/
+/****************************************************************************/
+
+int main(void)
+{
+    static const char *const apcBackends[] = { "scan", "wheel", "sorted" };
+    static uint8 au8Index[RANGE_NUM_TIMERS] = { 0, 1, 2, 3 };
+    TIMER_tHandle atTimers[RANGE_NUM_TIMERS];
+    uint32 u32Tick;
+    uint8 n;
+
+    TEST_CHECK(TIMER_eInit(asTimers, RANGE_NUM_TIMERS) == E_TIMER_OK);
+    for (n = 0; n < RANGE_NUM_TIMERS; n++)
+    {
+        TEST_CHECK(TIMER_eOpen(&atTimers[n], range_callback, &au8Index[n], TIMER_FLAG_ALLOW_SLEEP) == E_TIMER_OK);
+    }
+
+    TEST_CHECK(TIMER_eStart(atTimers[0], 5) == E_TIMER_OK);
+    TEST_CHECK(TIMER_eStart(atTimers[1], 0x90000000UL) == E_TIMER_OK);
+    TEST_CHECK(TIMER_eStart(atTimers[2], 0xFFFFFFFFUL) == E_TIMER_OK);
+#ifdef uint64
+    TEST_CHECK(TIMER_eStartAt(atTimers[3], TIMER_u64NowMs() + 0xC0000000UL) == E_TIMER_OK);
+#else
+    TEST_CHECK(TIMER_eStart(atTimers[3], 0xC0000000UL) == E_TIMER_OK);
+#endif
+
+    for (n = 0; n < RANGE_NUM_TICKS; n++)
+    {
+        ISR_vTickTimer();
+        TIMER_vTask();
+    }
+
+    TEST_CHECK(au8Fired[0] == 1);
+    for (n = 1; n < RANGE_NUM_TIMERS; n++)
+    {
+        TEST_CHECK(au8Fired[n] == 0);
+        TEST_CHECK(TIMER_eGetState(atTimers[n]) == E_TIMER_STATE_RUNNING);
+    }
+    TEST_CHECK(TIMER_u32NextExpiry() == 0x90000000UL - RANGE_NUM_TICKS);
+
+    /* None of the ticks raised while the task did not run is lost */
+    TEST_CHECK(TIMER_eStart(atTimers[0], RANGE_CATCH_UP) == E_TIMER_OK);
+    for (u32Tick = 0; u32Tick < RANGE_CATCH_UP; u32Tick++)
+    {
+        ISR_vTickTimer();
+    }
+    TIMER_vTask();
+    TEST_CHECK(au8Fired[0] == 2);
+    TEST_CHECK(!TIMER_bIsTickPending());
+    TEST_CHECK(TIMER_u32NowMs() == RANGE_NUM_TICKS + RANGE_CATCH_UP);
+    TEST_CHECK(TIMER_u32NextExpiry() == 0x90000000UL - RANGE_NUM_TICKS - RANGE_CATCH_UP);
+
+    printf("backend %s\n", apcBackends[TIMER_BACKEND]);
+    return TEST_iResult("test_timer_range");
+}
+
+/****************************************************************************/
+/***        Local Functions                                               ***/
+/****************************************************************************/
+
+static void range_callback(void *pvParam)
+{
+    au8Fired[*(uint8 *)pvParam]++;
+}
+
+/****************************************************************************/
+/***        END OF FILE                                                   ***/
+/****************************************************************************/
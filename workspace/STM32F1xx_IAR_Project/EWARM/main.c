@@ -33,6 +33,7 @@
 #include "prj_options.h"
 #include "app_main.h"
 #include "dbg.h"
+#include "Coroutine.h"
 #include "port_mcu.h"
 
 /** @addtogroup STM32F0xx_StdPeriph_Templates
@@ -53,6 +54,8 @@ static bool     BUTTON_bRead(void);
 static void APP_vInitialise(void);
 
 static void uart_initialize(void);
+static CO_teStatus uart_send_co(CO_tsState *psCo, uint8_t u8TxByte);
+static CO_teStatus uart_receive_co(CO_tsState *psCo);
 static void uart_drv_send(uint8_t u8TxByte);
 static uint8_t uart_drv_receive(void);
 
@@ -132,21 +135,36 @@ static bool BUTTON_bRead(void)
   return (bool)GPIO_ReadInputDataBit(GPIOA, GPIO_Pin_1);
 }
 
-static void uart_drv_send(uint8_t u8TxByte)
+static CO_teStatus uart_send_co(CO_tsState *psCo, uint8_t u8TxByte)
 {
-  /* write a character to the USART */
+  CO_BEGIN(psCo);
+  /* Write a character to the USART */
   USART_SendData(USART1, (uint8_t) u8TxByte);
+  /* Other work runs until the end of transmission */
+  CO_WAIT_WHILE(psCo, USART_GetFlagStatus(USART1, USART_FLAG_TC) == RESET);
+  CO_END(psCo);
+}
+
+static CO_teStatus uart_receive_co(CO_tsState *psCo)
+{
+  CO_BEGIN(psCo);
+  /* Other work runs until the Read data register flag is SET */
+  CO_WAIT_WHILE(psCo, USART_GetFlagStatus(USART1, USART_IT_RXNE) == RESET);
+  CO_END(psCo);
+}
+
+static void uart_drv_send(uint8_t u8TxByte)
+{
+  CO_tsState sCo;
 
-  /* Loop until the end of transmission */
-  while (USART_GetFlagStatus(USART1, USART_FLAG_TC) == RESET);
+  CO_BLOCK(&sCo, uart_send_co(&sCo, u8TxByte));
 }
 
 static uint8_t uart_drv_receive(void)
 {
-  /* Loop until the end of receive */
-  while (USART_GetFlagStatus(USART1, USART_IT_RXNE) == RESET);
+  CO_tsState sCo;
 
-  /* get data from USART */
+  CO_BLOCK(&sCo, uart_receive_co(&sCo));
   return (uint8)USART_ReceiveData(USART1);
 }
 
@@ -24,6 +24,14 @@
 /* Includes ------------------------------------------------------------------*/
 #include "stm32f10x_it.h"
 #include "Timer.h"
+#ifdef PORTABLE_SUPPORT_HRT
+#include "port_hrt.h"
+#endif
+#ifdef PORTABLE_SUPPORT_RTOS
+#include "cmsis_os.h"
+#endif
+#include "serial.h"
+#include "Defer.h"
 
 /** @addtogroup STM32F10x_StdPeriph_Template
   * @{
@@ -33,6 +41,9 @@
 /* Private define ------------------------------------------------------------*/
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
+#ifdef SERIAL_TOTAL_NUMBER
+extern uint8 u8SerialTest;
+#endif
 /* Private function prototypes -----------------------------------------------*/
 /* Private functions ---------------------------------------------------------*/
 
@@ -124,9 +135,12 @@ void DebugMon_Handler(void)
   * @param  None
   * @retval None
   */
+#ifndef PORTABLE_SUPPORT_RTOS
+/* The kernel switches threads in its own PendSV_Handler */
 void PendSV_Handler(void)
 {
 }
+#endif
 
 /**
   * @brief  This function handles SysTick Handler.
@@ -136,6 +150,9 @@ void PendSV_Handler(void)
 void SysTick_Handler(void)
 {
     ISR_vTickTimer();
+#ifdef PORTABLE_SUPPORT_RTOS
+    OS_vTick();
+#endif
 }
 
 /******************************************************************************/
@@ -154,6 +171,28 @@ void SysTick_Handler(void)
 {
 }*/
 
+#ifdef PORTABLE_SUPPORT_HRT
+/**
+  * @brief  This function handles TIM2 interrupt request.
+  * @param  None
+  * @retval None
+  */
+void TIM2_IRQHandler(void)
+{
+    /* Overflow first, so that the compare sees the extended count */
+    if (TIM_GetITStatus(TIM2, TIM_IT_Update) != RESET)
+    {
+        TIM_ClearITPendingBit(TIM2, TIM_IT_Update);
+        HRT_vIsrOverflow();
+    }
+    if (TIM_GetITStatus(TIM2, TIM_IT_CC1) != RESET)
+    {
+        TIM_ClearITPendingBit(TIM2, TIM_IT_CC1);
+        HRT_vIsrCompare();
+    }
+}
+#endif
+
 /**
   * @brief  This function handles USART interrupt request.
   * @param  None
@@ -161,6 +200,26 @@ void SysTick_Handler(void)
   */
 void USART1_IRQHandler(void)
 {
+#ifdef SERIAL_TOTAL_NUMBER
+    DEFER_ISR_ENTER();
+
+    /* Reading the data register clears RXNE; the byte is queued later */
+    if (USART_GetITStatus(USART1, USART_IT_RXNE) != RESET)
+    {
+        (void)DEFER_bPost(SERIAL_DEFER_LEVEL, SERIAL_vDeferPut, &u8SerialTest,
+                          USART_ReceiveData(USART1));
+    }
+
+    /* The next byte is taken from the TX queue outside the interrupt, which
+       SERIAL_vDeferSend enables again */
+    if (USART_GetITStatus(USART1, USART_IT_TXE) != RESET)
+    {
+        USART_ITConfig(USART1, USART_IT_TXE, DISABLE);
+        (void)DEFER_bPost(SERIAL_DEFER_LEVEL, SERIAL_vDeferSend, &u8SerialTest, 0);
+    }
+
+    DEFER_ISR_EXIT(SERIAL_DEFER_LEVEL);
+#endif
 }
 
 /******************* (C) COPYRIGHT 2011 STMicroelectronics *****END OF FILE****/
@@ -40,6 +40,9 @@
 #include "prj_options.h"
 #include "app_main.h"
 #include "Queue.h"
+#include "Scheduler.h"
+#include "Defer.h"
+#include "Coroutine.h"
 #include "Timer.h"
 #include "dbg.h"
 
@@ -73,6 +76,11 @@
 
 #define APP_TOTAL_TIMER   (APP_TIMER_BUTTON + APP_TIMER_LED)
 
+/* Scheduler slots, the lower the sooner a ready task runs */
+#define APP_TASK_DEFER          0
+#define APP_TASK_TIMER          1
+#define APP_TASK_BUTTON         2
+
 /****************************************************************************/
 /***        Type Definitions                                              ***/
 /****************************************************************************/
@@ -80,6 +88,9 @@
 /****************************************************************************/
 /***        Local Function Prototypes                                     ***/
 /****************************************************************************/
+#ifdef BUTTON_TOTAL_NUMBER
+static void APP_vButtonTask(void *pvParam);
+#endif
 
 /****************************************************************************/
 /***        Exported Variables                                            ***/
@@ -109,47 +120,10 @@ TIMER_tsTimer asTimers[APP_TOTAL_TIMER];
  ****************************************************************************/
 void APP_vMainLoop(void)
 {
+    /*TODO: add watchdog restart */
 
-    while (1)
-    {
-        /* call timer task handle soft timer */
-        TIMER_vTask();
-        
-        /*TODO: add watchdog restart */
-        
-        /*TODO: add main task */
-        #ifdef BUTTON_TOTAL_NUMBER
-        BUTTON_tsEvent sButtonEvent;
-        LED_tsEffect sEffect = {
-            .eEffect = E_LED_EFFECT_FLASH,
-            .u16TimeOn = 10,
-            .u16TimeOff = 10,
-            .u8Flash = 3,
-            .u16Period = 200,
-        };
-        if (QUEUE_bReceive(&APP_msgButtonEvents, &sButtonEvent))
-        {
-            switch (sButtonEvent.eState)
-            {
-            case E_BUTTON_STATE_RELEASE:
-                DBG_vPrintf(TRUE, "Button %d Release\n", sButtonEvent.u8NumberIndex);
-                break;
-            
-            case E_BUTTON_STATE_PRESS:
-                sEffect.u8Flash = sButtonEvent.u8Click;
-                LED_eStartEffect(u8LedTest, &sEffect);
-                DBG_vPrintf(TRUE, "Button %d Click %d Times\n", sButtonEvent.u8NumberIndex, sButtonEvent.u8Click);
-                break;
-
-            case E_BUTTON_STATE_HOLD_ON:
-                DBG_vPrintf(TRUE, "Button %d Hold on\n", sButtonEvent.u8NumberIndex);
-                break;
-            }
-        }
-        #endif
-        
-        /*TODO: add task management power */
-    }
+    /* Runs the tasks as their events come in and sleeps in between */
+    SCHED_vRun();
 }
 
 
@@ -191,6 +165,18 @@ void APP_vInitResources(void)
     BUTTON_eInit();
     #endif
 
+    SCHED_vInit();
+    /* Work posted by interrupt handlers runs before any other task */
+    DEFER_vInit();
+    SCHED_bAddDeferTask(APP_TASK_DEFER);
+    SCHED_bAddTimerTask(APP_TASK_TIMER);
+    /* Driver waits (UART, SD card) let higher priority tasks run */
+    CO_vSetIdle(SCHED_vYield);
+    #ifdef BUTTON_TOTAL_NUMBER
+    SCHED_bAddTask(APP_TASK_BUTTON, APP_vButtonTask, NULL);
+    SCHED_bBindQueue(APP_TASK_BUTTON, &APP_msgButtonEvents);
+    #endif
+
     #ifdef LED_TOTAL_NUMBER
     LED_eInit();
     #endif
@@ -204,6 +190,51 @@ void APP_vInitResources(void)
 /***        Local Functions                                               ***/
 /****************************************************************************/
 
+#ifdef BUTTON_TOTAL_NUMBER
+/****************************************************************************
+ *
+ * NAME: APP_vButtonTask
+ *
+ * DESCRIPTION:
+ * Handles one button event; the scheduler runs it again while more are queued
+ *
+ * RETURNS:
+ * void
+ *
+ ****************************************************************************/
+static void APP_vButtonTask(void *pvParam)
+{
+    BUTTON_tsEvent sButtonEvent;
+    LED_tsEffect sEffect = {
+        .eEffect = E_LED_EFFECT_FLASH,
+        .u16TimeOn = 10,
+        .u16TimeOff = 10,
+        .u8Flash = 3,
+        .u16Period = 200,
+    };
+
+    if (QUEUE_bReceive(&APP_msgButtonEvents, &sButtonEvent))
+    {
+        switch (sButtonEvent.eState)
+        {
+        case E_BUTTON_STATE_RELEASE:
+            DBG_vPrintf(TRUE, "Button %d Release\n", sButtonEvent.u8NumberIndex);
+            break;
+
+        case E_BUTTON_STATE_PRESS:
+            sEffect.u8Flash = sButtonEvent.u8Click;
+            LED_eStartEffect(u8LedTest, &sEffect);
+            DBG_vPrintf(TRUE, "Button %d Click %d Times\n", sButtonEvent.u8NumberIndex, sButtonEvent.u8Click);
+            break;
+
+        case E_BUTTON_STATE_HOLD_ON:
+            DBG_vPrintf(TRUE, "Button %d Hold on\n", sButtonEvent.u8NumberIndex);
+            break;
+        }
+    }
+}
+#endif
+
 /****************************************************************************/
 /***        END OF FILE                                                   ***/
 /****************************************************************************/
@@ -29,6 +29,11 @@
 /* Includes ------------------------------------------------------------------*/
 #include "stm8l15x_it.h"
 #include "Timer.h"
+#ifdef PORTABLE_SUPPORT_HRT
+#include "port_hrt.h"
+#endif
+#include "serial.h"
+#include "Defer.h"
 
 /** @addtogroup STM8L15x_StdPeriph_Template
   * @{
@@ -42,6 +47,9 @@
 /* Private functions ---------------------------------------------------------*/
 /* Public functions ----------------------------------------------------------*/
 extern void disk_timerproc (void);
+#ifdef SERIAL_TOTAL_NUMBER
+extern uint8 u8SerialTest;
+#endif
 
 #ifdef _COSMIC_
 /**
@@ -292,6 +300,13 @@ INTERRUPT_HANDLER(TIM2_UPD_OVF_TRG_BRK_USART2_TX_IRQHandler,19)
     /* In order to detect unexpected events during development,
        it is recommended to set a breakpoint on the following instruction.
     */
+#ifdef PORTABLE_SUPPORT_HRT
+    if (TIM2_GetITStatus(TIM2_IT_Update) != RESET)
+    {
+        TIM2_ClearITPendingBit(TIM2_IT_Update);
+        HRT_vIsrOverflow();
+    }
+#endif
 }
 
 /**
@@ -304,6 +319,13 @@ INTERRUPT_HANDLER(TIM2_CC_USART2_RX_IRQHandler,20)
     /* In order to detect unexpected events during development,
        it is recommended to set a breakpoint on the following instruction.
     */
+#ifdef PORTABLE_SUPPORT_HRT
+    if (TIM2_GetITStatus(TIM2_IT_CC1) != RESET)
+    {
+        TIM2_ClearITPendingBit(TIM2_IT_CC1);
+        HRT_vIsrCompare();
+    }
+#endif
 }
 
 
@@ -388,9 +410,19 @@ INTERRUPT_HANDLER(SPI1_IRQHandler,26)
   */
 INTERRUPT_HANDLER(USART1_TX_TIM5_UPD_OVF_TRG_BRK_IRQHandler,27)
 {
-    /* In order to detect unexpected events during development,
-       it is recommended to set a breakpoint on the following instruction.
-    */
+#ifdef SERIAL_TOTAL_NUMBER
+    DEFER_ISR_ENTER();
+
+    /* The next byte is taken from the TX queue outside the interrupt, which
+       SERIAL_vDeferSend enables again */
+    if (USART_GetITStatus(USART1, USART_IT_TXE) != RESET)
+    {
+        USART_ITConfig(USART1, USART_IT_TXE, DISABLE);
+        (void)DEFER_bPost(SERIAL_DEFER_LEVEL, SERIAL_vDeferSend, &u8SerialTest, 0);
+    }
+
+    DEFER_ISR_EXIT(SERIAL_DEFER_LEVEL);
+#endif
 }
 
 /**
@@ -400,9 +432,18 @@ INTERRUPT_HANDLER(USART1_TX_TIM5_UPD_OVF_TRG_BRK_IRQHandler,27)
   */
 INTERRUPT_HANDLER(USART1_RX_TIM5_CC_IRQHandler,28)
 {
-    /* In order to detect unexpected events during development,
-       it is recommended to set a breakpoint on the following instruction.
-    */
+#ifdef SERIAL_TOTAL_NUMBER
+    DEFER_ISR_ENTER();
+
+    /* Reading the data register clears RXNE; the byte is queued later */
+    if (USART_GetITStatus(USART1, USART_IT_RXNE) != RESET)
+    {
+        (void)DEFER_bPost(SERIAL_DEFER_LEVEL, SERIAL_vDeferPut, &u8SerialTest,
+                          USART_ReceiveData8(USART1));
+    }
+
+    DEFER_ISR_EXIT(SERIAL_DEFER_LEVEL);
+#endif
 }
 
 /**
@@ -34,6 +34,7 @@
 #include "prj_options.h"
 #include "app_main.h"
 #include "dbg.h"
+#include "Coroutine.h"
 #include "port_mcu.h"
 #include "serial.h"
 
@@ -49,6 +50,8 @@ static bool     BUTTON_bRead(void);
 static void APP_vInitialise(void);
 
 static void uart_initialize(void);
+static CO_teStatus uart_send_co(CO_tsState *psCo, uint8_t u8TxByte);
+static CO_teStatus uart_receive_co(CO_tsState *psCo);
 static void uart_drv_send(uint8_t u8TxByte);
 static uint8_t uart_drv_receive(void);
 // static void uart_start_send(void);
@@ -117,15 +120,36 @@ static bool BUTTON_bRead(void)
     return (bool)GPIO_ReadInputPin(GPIOA, GPIO_PIN_1);
 }
 
-static void uart_drv_send(uint8_t u8TxByte)
+static CO_teStatus uart_send_co(CO_tsState *psCo, uint8_t u8TxByte)
 {
+    CO_BEGIN(psCo);
+    /* Write a character to the USART */
     UART1_SendData8(u8TxByte);
-    while (UART1_GetFlagStatus(UART1_FLAG_TXE) == RESET);
+    /* Other work runs until the data register is free again */
+    CO_WAIT_WHILE(psCo, UART1_GetFlagStatus(UART1_FLAG_TXE) == RESET);
+    CO_END(psCo);
+}
+
+static CO_teStatus uart_receive_co(CO_tsState *psCo)
+{
+    CO_BEGIN(psCo);
+    /* Other work runs until the Read data register flag is SET */
+    CO_WAIT_WHILE(psCo, UART1_GetFlagStatus(UART1_FLAG_RXNE) == RESET);
+    CO_END(psCo);
+}
+
+static void uart_drv_send(uint8_t u8TxByte)
+{
+    CO_tsState sCo;
+
+    CO_BLOCK(&sCo, uart_send_co(&sCo, u8TxByte));
 }
 
 static uint8_t uart_drv_receive(void)
 {
-    while (UART1_GetFlagStatus(UART1_FLAG_RXNE) == RESET);
+    CO_tsState sCo;
+
+    CO_BLOCK(&sCo, uart_receive_co(&sCo));
     return UART1_ReceiveData8();
 }
 
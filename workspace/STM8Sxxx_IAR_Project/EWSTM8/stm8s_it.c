@@ -30,7 +30,11 @@
 /* Includes ------------------------------------------------------------------*/
 #include "stm8s_it.h"
 #include "Timer.h"
+#ifdef PORTABLE_SUPPORT_HRT
+#include "port_hrt.h"
+#endif
 #include "serial.h"
+#include "Defer.h"
 
 /** @addtogroup Template_Project
   * @{
@@ -43,7 +47,9 @@
 /* Private function prototypes -----------------------------------------------*/
 /* Private functions ---------------------------------------------------------*/
 /* Public functions ----------------------------------------------------------*/
+#ifdef SERIAL_TOTAL_NUMBER
 extern uint8 u8SerialTest;
+#endif
 
 #ifdef _COSMIC_
 /**
@@ -282,6 +288,13 @@ INTERRUPT_HANDLER(TIM1_CAP_COM_IRQHandler, 12)
   /* In order to detect unexpected events during development,
      it is recommended to set a breakpoint on the following instruction.
   */
+#ifdef PORTABLE_SUPPORT_HRT
+  if (TIM2_GetITStatus(TIM2_IT_UPDATE) != RESET)
+  {
+    TIM2_ClearITPendingBit(TIM2_IT_UPDATE);
+    HRT_vIsrOverflow();
+  }
+#endif
  }
 
 /**
@@ -294,6 +307,13 @@ INTERRUPT_HANDLER(TIM1_CAP_COM_IRQHandler, 12)
   /* In order to detect unexpected events during development,
      it is recommended to set a breakpoint on the following instruction.
   */
+#ifdef PORTABLE_SUPPORT_HRT
+  if (TIM2_GetITStatus(TIM2_IT_CC1) != RESET)
+  {
+    TIM2_ClearITPendingBit(TIM2_IT_CC1);
+    HRT_vIsrCompare();
+  }
+#endif
  }
 #endif /* (STM8S903) || (STM8AF622x) */
 
@@ -333,18 +353,16 @@ INTERRUPT_HANDLER(TIM1_CAP_COM_IRQHandler, 12)
   */
  INTERRUPT_HANDLER(UART1_TX_IRQHandler, 17)
  {
-    /* In order to detect unexpected events during development,
-       it is recommended to set a breakpoint on the following instruction.
-    */
-   // uint8 u8Byte;
-   // if (!SERIAL_eGet(u8SerialTest, &u8Byte))
-   // {
-   //    SERIAL_vSend(u8SerialTest, u8Byte);
-   // }
-   // else
-   // {
-   //    SERIAL_vStopSend(u8SerialTest);
-   // }
+#ifdef SERIAL_TOTAL_NUMBER
+    DEFER_ISR_ENTER();
+
+    /* The next byte is taken from the TX queue outside the interrupt, which
+       SERIAL_vDeferSend enables again */
+    UART1_ITConfig(UART1_IT_TXE, DISABLE);
+    (void)DEFER_bPost(SERIAL_DEFER_LEVEL, SERIAL_vDeferSend, &u8SerialTest, 0);
+
+    DEFER_ISR_EXIT(SERIAL_DEFER_LEVEL);
+#endif
  }
 
 /**
@@ -354,11 +372,15 @@ INTERRUPT_HANDLER(TIM1_CAP_COM_IRQHandler, 12)
   */
  INTERRUPT_HANDLER(UART1_RX_IRQHandler, 18)
  {
-    /* In order to detect unexpected events during development,
-       it is recommended to set a breakpoint on the following instruction.
-    */
-   // uint8 u8Byte = SERIAL_u8Receive(u8SerialTest);
-   // SERIAL_ePut(u8SerialTest, u8Byte);
+#ifdef SERIAL_TOTAL_NUMBER
+    DEFER_ISR_ENTER();
+
+    /* Reading the data register clears RXNE; the byte is queued later */
+    (void)DEFER_bPost(SERIAL_DEFER_LEVEL, SERIAL_vDeferPut, &u8SerialTest,
+                      UART1_ReceiveData8());
+
+    DEFER_ISR_EXIT(SERIAL_DEFER_LEVEL);
+#endif
  }
 #endif /* (STM8S208) || (STM8S207) || (STM8S103) || (STM8S903) || (STM8AF62Ax) || (STM8AF52Ax) */
 